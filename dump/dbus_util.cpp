@@ -2,36 +2,86 @@
 
 #include "dbus_util.hpp"
 
+#include <systemd/sd-bus.h>
+
+#include <cstring>
+
 namespace openpower::dump
 {
 using ::openpower::dump::utility::DbusVariantType;
+using ::openpower::dump::utility::toDumpSubtype;
+using ::openpower::dump::utility::toDumpType;
+using ::openpower::dump::utility::toPldmFileType;
 
-bool isDumpProgressCompleted(sdbusplus::bus::bus& bus,
-                             const std::string& objectPath)
+namespace
 {
-    try
+using BiosAttributeValue = std::variant<int64_t, std::string>;
+using BootProgressVariant = sdbusplus::utility::dedup_variant_t<ProgressStages>;
+
+constexpr auto biosConfigService = "xyz.openbmc_project.BIOSConfigManager";
+constexpr auto biosConfigObjPath = "/xyz/openbmc_project/bios_config/manager";
+constexpr auto biosConfigIntf = "xyz.openbmc_project.BIOSConfig.Manager";
+constexpr auto hmcManagedAttr = "pvm_hmc_managed";
+constexpr auto hostStateService = "xyz.openbmc_project.State.Host";
+constexpr auto hostStateObjPath = "/xyz/openbmc_project/state/host0";
+constexpr auto bootProgressIntf = "xyz.openbmc_project.State.Boot.Progress";
+
+/**
+ * @brief Read the HMC managed state from the value of the BIOS attribute
+ * @param[in] attrValue current value of the pvm_hmc_managed attribute
+ * @return true if HMC managed else false, std::nullopt if the value is not
+ *         of the expected type
+ */
+std::optional<bool> toHMCManaged(const BiosAttributeValue& attrValue)
+{
+    const std::string* strValue = std::get_if<std::string>(&attrValue);
+    if (strValue == nullptr)
     {
-        auto retVal = readDBusProperty<DbusVariantType>(
-            bus, dumpService, objectPath, progressIntf, "Status");
-        auto status = std::get_if<std::string>(&retVal);
-        if (status != nullptr)
-        {
-            if (*status == progressComplete)
-            {
-                return true;
-            }
-        }
+        lg2::error("Unexpected value type for '{ATTR}'", "ATTR",
+                   hmcManagedAttr);
+        return std::nullopt;
+    }
+    lg2::info("isSystemHMCManaged : {VALUE} ", "VALUE", *strValue);
+    return *strValue == "Enabled";
+}
+
+/**
+ * @brief Check if the host BootProgress is OSRunning
+ * @param[in] retVal BootProgress property value
+ * @return true if host is running else false
+ */
+bool isOSRunning(const BootProgressVariant& retVal)
+{
+    const ProgressStages* progPtr = std::get_if<ProgressStages>(&retVal);
+    if (progPtr == nullptr)
+    {
+        return false;
     }
-    catch (const std::exception& ex)
+    if (*progPtr == ProgressStages::OSRunning)
     {
-        lg2::error(
-            "Util failed to dump progress property path:{PATH} exception:{EX}",
-            "PATH", objectPath, "EX", ex);
-        throw;
+        lg2::info("Host is in  BootProgress::OSRunning");
+        return true;
     }
+    lg2::info("Host is not in BootProgress::OSRunning state");
     return false;
 }
 
+/**
+ * @brief Throw if the sd-bus message call failed
+ * @param[in] rc return code of the sd-bus call
+ * @return return code of the sd-bus call
+ */
+int checkMessageRc(int rc)
+{
+    if (rc < 0)
+    {
+        throw std::runtime_error(
+            std::string("Failed to parse D-Bus message: ") + strerror(-rc));
+    }
+    return rc;
+}
+} // namespace
+
 bool isDumpProgressCompleted(const DBusPropertiesMap& propMap)
 {
     for (auto prop : propMap)
@@ -51,127 +101,336 @@ bool isDumpProgressCompleted(const DBusPropertiesMap& propMap)
     return false;
 }
 
-uint64_t getDumpSize(sdbusplus::bus::bus& bus, const std::string& objectPath)
+bool isDumpOffloaded(const DBusPropertiesMap& propMap)
 {
-    uint64_t size = 0;
-    try
+    auto prop = propMap.find("Offloaded");
+    if (prop == propMap.end())
+    {
+        return false;
+    }
+    const bool* offloaded = std::get_if<bool>(&prop->second);
+    return offloaded != nullptr && *offloaded;
+}
+
+void updateDumpEntry(DumpEntry& entry, const std::string& intf,
+                     const DBusPropertiesMap& propMap)
+{
+    if (intf == progressIntf)
+    {
+        if (isDumpProgressCompleted(propMap))
+        {
+            entry.completed = true;
+        }
+        auto prop = propMap.find("CompletedTime");
+        if (prop != propMap.end())
+        {
+            const uint64_t* timePtr = std::get_if<uint64_t>(&prop->second);
+            if (timePtr != nullptr)
+            {
+                entry.completedTime = *timePtr;
+            }
+        }
+    }
+    else if (intf == entryIntf)
     {
-        auto retVal = readDBusProperty<DbusVariantType>(
-            bus, dumpService, objectPath, entryIntf, "Size");
-        const uint64_t* sizePtr = std::get_if<uint64_t>(&retVal);
-        if (sizePtr == nullptr)
+        auto prop = propMap.find("Size");
+        if (prop != propMap.end())
         {
-            lg2::error(
-                "Size property value not set for dump object path:{PATH} ",
-                "PATH", objectPath);
-            throw std::runtime_error("Size property value not set for dump");
+            const uint64_t* sizePtr = std::get_if<uint64_t>(&prop->second);
+            if (sizePtr != nullptr)
+            {
+                entry.size = *sizePtr;
+            }
+        }
+        if (isDumpOffloaded(propMap))
+        {
+            entry.offloaded = true;
         }
-        size = *sizePtr;
     }
-    catch (const std::exception& ex)
+    else if (intf == filePathIntf)
     {
-        lg2::info("Failed to get dump size property value "
-                  "exception:{EX} path:{PATH}",
-                  "EX", ex, "PATH", objectPath);
-        throw;
+        auto prop = propMap.find("Path");
+        if (prop != propMap.end())
+        {
+            const std::string* pathPtr =
+                std::get_if<std::string>(&prop->second);
+            if (pathPtr != nullptr)
+            {
+                entry.filePath = *pathPtr;
+            }
+        }
     }
-    return size;
 }
 
-bool isSystemHMCManaged(sdbusplus::bus::bus& bus)
+bool readDumpEntryAdded(sdbusplus::message::message& msg,
+                        object_path& objPath, DumpEntry& entry)
 {
-    auto retVal = readDBusProperty<std::variant<BaseBIOSTableItemList>>(
-        bus, "xyz.openbmc_project.BIOSConfigManager",
-        "/xyz/openbmc_project/bios_config/manager",
-        "xyz.openbmc_project.BIOSConfig.Manager", "BaseBIOSTable");
+    sd_bus_message* m = msg.get();
 
-    if (std::holds_alternative<BaseBIOSTableItemList>(retVal))
+    // first pass, decode only the interface names to classify the object
+    msg.read(objPath);
+    std::optional<DumpSubtype> subtype;
+    checkMessageRc(sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY,
+                                                  "{sa{sv}}"));
+    while (checkMessageRc(sd_bus_message_enter_container(
+               m, SD_BUS_TYPE_DICT_ENTRY, "sa{sv}")) > 0)
     {
-        const auto& baseBiosTable = std::get<BaseBIOSTableItemList>(retVal);
-        auto it = baseBiosTable.find("pvm_hmc_managed");
-        if (it != baseBiosTable.end())
+        const char* intf = nullptr;
+        checkMessageRc(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &intf));
+        if (auto found = toDumpSubtype(intf))
         {
-            const auto& attrValue = std::get<5>(it->second);
-            if (std::holds_alternative<std::string>(attrValue))
-            {
-                const std::string& strValue = std::get<std::string>(attrValue);
-                lg2::info("isSystemHMCManaged : {VALUE} ", "VALUE", strValue);
-                return strValue == "Enabled";
-            }
+            subtype = found;
         }
+        checkMessageRc(sd_bus_message_skip(m, "a{sv}"));
+        checkMessageRc(sd_bus_message_exit_container(m));
     }
-    throw std::runtime_error("Failed to read HMC managed property");
-    return false;
-}
+    checkMessageRc(sd_bus_message_exit_container(m));
+    if (!subtype)
+    {
+        return false;
+    }
+    entry.subtype = *subtype;
+    entry.type = toDumpType(*subtype);
+    entry.fileType = toPldmFileType(*subtype);
 
-bool isHostRunning(sdbusplus::bus::bus& bus)
-{
-    try
+    // second pass, decode the properties carrying the entry metadata
+    checkMessageRc(sd_bus_message_rewind(m, true));
+    msg.read(objPath);
+    checkMessageRc(sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY,
+                                                  "{sa{sv}}"));
+    while (checkMessageRc(sd_bus_message_enter_container(
+               m, SD_BUS_TYPE_DICT_ENTRY, "sa{sv}")) > 0)
     {
-        using PropertiesVariant =
-            sdbusplus::utility::dedup_variant_t<ProgressStages>;
-
-        constexpr auto hostStateObjPath = "/xyz/openbmc_project/state/host0";
-        auto retVal = readDBusProperty<PropertiesVariant>(
-            bus, "xyz.openbmc_project.State.Host", hostStateObjPath,
-            "xyz.openbmc_project.State.Boot.Progress", "BootProgress");
-        const ProgressStages* progPtr = std::get_if<ProgressStages>(&retVal);
-        if (progPtr == nullptr)
+        const char* intf = nullptr;
+        checkMessageRc(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &intf));
+        if (std::strcmp(intf, progressIntf) == 0 ||
+            std::strcmp(intf, entryIntf) == 0 ||
+            std::strcmp(intf, filePathIntf) == 0)
         {
-            return false;
+            DBusPropertiesMap propMap;
+            msg.read(propMap);
+            updateDumpEntry(entry, intf, propMap);
         }
-        if (*progPtr == ProgressStages::OSRunning)
+        else
         {
-            lg2::info("Host is in  BootProgress::OSRunning");
-            return true;
+            checkMessageRc(sd_bus_message_skip(m, "a{sv}"));
         }
+        checkMessageRc(sd_bus_message_exit_container(m));
     }
-    catch (const std::exception& ex)
+    checkMessageRc(sd_bus_message_exit_container(m));
+    return true;
+}
+
+uint32_t getDumpId(const std::string& objectPath, DumpType type)
+{
+    object_path path = objectPath;
+    if (type == DumpType::bmc)
     {
-        lg2::error("Failed to read BootProgress property exception:{EX}", "EX",
-                   ex);
+        return std::stoul(path.filename());
     }
-    lg2::info("Host is not in BootProgress::OSRunning state");
-    return false;
+    return std::strtoul(path.filename().c_str(), nullptr, 16);
+}
+
+sdbusplus::slot_t getDumpSizeAsync(
+    sdbusplus::bus::bus& bus, const std::string& objectPath,
+    std::function<void(std::optional<uint64_t>)>&& callback)
+{
+    return readDBusPropertyAsync<DbusVariantType>(
+        bus, dumpService, objectPath, entryIntf, "Size",
+        [objectPath, callback = std::move(callback)](
+            std::optional<DbusVariantType> retVal) {
+            std::optional<uint64_t> size;
+            if (retVal)
+            {
+                if (const uint64_t* sizePtr = std::get_if<uint64_t>(&*retVal))
+                {
+                    size = *sizePtr;
+                }
+                else
+                {
+                    lg2::error("Size property value not set for dump object "
+                               "path:{PATH} ",
+                               "PATH", objectPath);
+                }
+            }
+            callback(size);
+        });
+}
+
+sdbusplus::slot_t isSystemHMCManagedAsync(
+    sdbusplus::bus::bus& bus,
+    std::function<void(std::optional<bool>)>&& callback)
+{
+    // read the one attribute instead of the whole BaseBIOSTable
+    auto method = bus.new_method_call(biosConfigService, biosConfigObjPath,
+                                      biosConfigIntf, "GetAttribute");
+    method.append(hmcManagedAttr);
+    return bus.call_async(
+        method,
+        [callback = std::move(callback)](sdbusplus::message::message& reply) {
+            std::optional<bool> hmcManaged;
+            try
+            {
+                if (reply.is_method_error())
+                {
+                    throw std::runtime_error(reply.get_error()->name);
+                }
+                std::string attrType;
+                BiosAttributeValue currentValue;
+                BiosAttributeValue pendingValue;
+                reply.read(attrType, currentValue, pendingValue);
+                hmcManaged = toHMCManaged(currentValue);
+            }
+            catch (const std::exception& ex)
+            {
+                lg2::error("Failed to get the BIOS attribute:{ATTR} ex:{EX}",
+                           "ATTR", hmcManagedAttr, "EX", ex);
+            }
+            callback(hmcManaged);
+        });
 }
 
-const std::vector<std::string>
-    getDumpEntryObjPaths(sdbusplus::bus::bus& bus, const std::string& entryIntf)
+std::optional<bool> readHMCManagedChanged(sdbusplus::message::message& msg)
 {
-    std::vector<std::string> liObjectPaths;
-    try
+    sd_bus_message* m = msg.get();
+    std::optional<bool> hmcManaged;
+
+    // walk the signal without decoding it, only the value of the one
+    // attribute is read out of the BaseBIOSTable
+    const char* intf = nullptr;
+    checkMessageRc(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &intf));
+    checkMessageRc(
+        sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "{sv}"));
+    while (checkMessageRc(sd_bus_message_enter_container(
+               m, SD_BUS_TYPE_DICT_ENTRY, "sv")) > 0)
     {
-        auto mapperCall = bus.new_method_call(
-            "xyz.openbmc_project.ObjectMapper",
-            "/xyz/openbmc_project/object_mapper",
-            "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths");
-        const int32_t depth = 0;
-        std::vector<std::string> intf;
-        if (entryIntf.find("System") != std::string::npos)
+        const char* prop = nullptr;
+        checkMessageRc(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &prop));
+        if (std::strcmp(prop, "BaseBIOSTable") != 0)
         {
-            intf.assign(
-                {"com.ibm.Dump.Entry.SBE", "com.ibm.Dump.Entry.Hostboot",
-                 "com.ibm.Dump.Entry.Hardware"});
+            checkMessageRc(sd_bus_message_skip(m, "v"));
+            checkMessageRc(sd_bus_message_exit_container(m));
+            continue;
         }
-        else
+
+        checkMessageRc(sd_bus_message_enter_container(m, SD_BUS_TYPE_VARIANT,
+                                                      "a{s(sbsssvva(svs))}"));
+        checkMessageRc(sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY,
+                                                      "{s(sbsssvva(svs))}"));
+        while (checkMessageRc(sd_bus_message_enter_container(
+                   m, SD_BUS_TYPE_DICT_ENTRY, "s(sbsssvva(svs))")) > 0)
         {
-            intf.push_back(entryIntf);
+            const char* attr = nullptr;
+            checkMessageRc(
+                sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &attr));
+            if (std::strcmp(attr, hmcManagedAttr) != 0)
+            {
+                checkMessageRc(sd_bus_message_skip(m, "(sbsssvva(svs))"));
+                checkMessageRc(sd_bus_message_exit_container(m));
+                continue;
+            }
+
+            // attribute name, read only, type, display name and help text
+            // precede the current value
+            checkMessageRc(sd_bus_message_enter_container(
+                m, SD_BUS_TYPE_STRUCT, "sbsssvva(svs)"));
+            checkMessageRc(sd_bus_message_skip(m, "sbsss"));
+            BiosAttributeValue currentValue;
+            msg.read(currentValue);
+            hmcManaged = toHMCManaged(currentValue);
+            checkMessageRc(sd_bus_message_skip(m, "va(svs)"));
+            checkMessageRc(sd_bus_message_exit_container(m));
+            checkMessageRc(sd_bus_message_exit_container(m));
         }
-        mapperCall.append(dumpObjPath);
-        mapperCall.append(depth);
-        mapperCall.append(intf);
-        auto response = bus.call(mapperCall);
-        response.read(liObjectPaths);
-        lg2::info("Dumps size received is:{SIZE} entryIntf:{INTF}", "SIZE",
-                  liObjectPaths.size(), "INTF", entryIntf);
+        checkMessageRc(sd_bus_message_exit_container(m));
+        checkMessageRc(sd_bus_message_exit_container(m));
+        checkMessageRc(sd_bus_message_exit_container(m));
     }
-    catch (const std::exception& ex)
-    {
-        lg2::error("Failed to get dump entry intf:{INTF} ex:{EX}", "INTF",
-                   entryIntf, "EX", ex);
-        throw;
-    }
-    return liObjectPaths;
+    checkMessageRc(sd_bus_message_exit_container(m));
+    return hmcManaged;
+}
+
+sdbusplus::slot_t isHostRunningAsync(sdbusplus::bus::bus& bus,
+                                     std::function<void(bool)>&& callback)
+{
+    return readDBusPropertyAsync<BootProgressVariant>(
+        bus, hostStateService, hostStateObjPath, bootProgressIntf,
+        "BootProgress",
+        [callback = std::move(callback)](
+            std::optional<BootProgressVariant> retVal) {
+            if (!retVal)
+            {
+                lg2::info("Host is not in BootProgress::OSRunning state");
+            }
+            callback(retVal && isOSRunning(*retVal));
+        });
+}
+
+sdbusplus::slot_t getDumpManagedObjectsAsync(
+    sdbusplus::bus::bus& bus,
+    std::function<void(std::optional<ManagedObjectType>)>&& callback)
+{
+    auto method = bus.new_method_call(dumpService, dumpObjPath,
+                                      dbusObjManagerIntf, "GetManagedObjects");
+    return bus.call_async(
+        method,
+        [callback = std::move(callback)](sdbusplus::message::message& reply) {
+            std::optional<ManagedObjectType> objects;
+            try
+            {
+                if (reply.is_method_error())
+                {
+                    throw std::runtime_error(reply.get_error()->name);
+                }
+                ManagedObjectType value;
+                reply.read(value);
+                lg2::info("Dump objects received is:{SIZE}", "SIZE",
+                          value.size());
+                objects = std::move(value);
+            }
+            catch (const std::exception& ex)
+            {
+                lg2::error("Failed to get dump managed objects ex:{EX}", "EX",
+                           ex);
+            }
+            callback(std::move(objects));
+        });
+}
+
+sdbusplus::slot_t getDumpEntryObjPathsAsync(
+    sdbusplus::bus::bus& bus, const std::vector<std::string>& interfaces,
+    std::function<void(std::optional<std::vector<std::string>>)>&& callback)
+{
+    auto mapperCall = bus.new_method_call(
+        "xyz.openbmc_project.ObjectMapper",
+        "/xyz/openbmc_project/object_mapper",
+        "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths");
+    const int32_t depth = 0;
+    mapperCall.append(dumpObjPath);
+    mapperCall.append(depth);
+    mapperCall.append(interfaces);
+    return bus.call_async(
+        mapperCall,
+        [callback = std::move(callback)](sdbusplus::message::message& reply) {
+            std::optional<std::vector<std::string>> paths;
+            try
+            {
+                if (reply.is_method_error())
+                {
+                    throw std::runtime_error(reply.get_error()->name);
+                }
+                std::vector<std::string> value;
+                reply.read(value);
+                lg2::info("Dumps size received is:{SIZE}", "SIZE",
+                          value.size());
+                paths = std::move(value);
+            }
+            catch (const std::exception& ex)
+            {
+                lg2::error("Failed to get dump entry paths ex:{EX}", "EX", ex);
+            }
+            callback(std::move(paths));
+        });
 }
 
 } // namespace openpower::dump
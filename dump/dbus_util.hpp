@@ -5,20 +5,18 @@
 #include <phosphor-logging/lg2.hpp>
 
 #include <cstdint>
+#include <functional>
+#include <optional>
 
 namespace openpower::dump
 {
 using ::openpower::dump::utility::DBusPropertiesMap;
+using ::openpower::dump::utility::DumpEntry;
+using ::openpower::dump::utility::DumpSubtype;
+using ::openpower::dump::utility::DumpType;
+using ::openpower::dump::utility::ManagedObjectType;
 using ::sdbusplus::message::object_path;
 
-using BaseBIOSTableItem = std::tuple<
-    std::string, bool, std::string, std::string, std::string,
-    std::variant<int64_t, std::string>, std::variant<int64_t, std::string>,
-    std::vector<std::tuple<std::string, std::variant<int64_t, std::string>,
-                           std::string>>>;
-
-using BaseBIOSTableItemList = std::map<std::string, BaseBIOSTableItem>;
-
 /**
  * @brief Read progress property from the interface map object
  * @param[in] propMap map of properties and its values
@@ -27,80 +25,167 @@ using BaseBIOSTableItemList = std::map<std::string, BaseBIOSTableItem>;
 bool isDumpProgressCompleted(const DBusPropertiesMap& propMap);
 
 /**
- * @brief Read progress property from the D-Bus object
- * @param[in] bus - D-Bus handle
- * @param[in] objectPath - D-Bus object path
- * @return true if progress is complete else false
+ * @brief Read offloaded property from the dump entry interface properties
+ * @param[in] propMap map of properties and its values
+ * @return true if the dump is offloaded else false
  */
-bool isDumpProgressCompleted(sdbusplus::bus::bus& bus,
-                             const std::string& objectPath);
+bool isDumpOffloaded(const DBusPropertiesMap& propMap);
+
 /**
- * @brief Read dump size from the interface map object
- * @param[in] bus - D-Bus handle
- * @param[in] objectPath - path of the D-Bus entry object
- * @return dump size value
+ * @brief Update dump entry metadata from the properties of an interface
+ * @param[in] entry dump entry to update
+ * @param[in] intf interface the properties belong to
+ * @param[in] propMap map of properties and its values
  */
-uint64_t getDumpSize(sdbusplus::bus::bus& bus, const std::string& objectPath);
+void updateDumpEntry(DumpEntry& entry, const std::string& intf,
+                     const DBusPropertiesMap& propMap);
 
 /**
- * @brief Read D-Bus property to check if system is HMC managed
- * @detail Read the property from BIOSConfig.Manager interface, if attribute
- *         is not set it will be assumed system is non HMC managed system.
- *         Assumption is that if it is HMC managed the attribute will be set.
- * @param[in] bus D-Bus handle
- * @return true if HMC managed else false
+ * @brief Read the dump entry of an InterfacesAdded signal
+ * @details The interface names are decoded first to classify the object,
+ *          properties are decoded only for dump entries and only for the
+ *          interfaces carrying the entry metadata.
+ * @param[in] msg InterfacesAdded signal
+ * @param[out] objPath object path of the added object
+ * @param[out] entry entry metadata, set only if the object is a dump entry
+ * @return true if the object is a dump entry else false
  */
-bool isSystemHMCManaged(sdbusplus::bus::bus& bus);
+bool readDumpEntryAdded(sdbusplus::message::message& msg,
+                        object_path& objPath, DumpEntry& entry);
+
+/**
+ * @brief Parse the dump id from the dump entry object path
+ * @param[in] objectPath - path of the D-Bus entry object
+ * @param[in] type - type of the dump
+ * @return dump id
+ */
+uint32_t getDumpId(const std::string& objectPath, DumpType type);
 
 /**
  * @brief Read property value from the specified object and interface
+ *        without blocking the event loop
  * @param[in] bus D-Bus handle
  * @param[in] service service which has implemented the interface
  * @param[in] object object having has implemented the interface
  * @param[in] intf interface having the property
  * @param[in] prop name of the property to read
- * @return property value
+ * @param[in] callback invoked with the property value once the reply is
+ *            received, std::nullopt if the property could not be read
+ * @return slot of the pending call, the call is cancelled if the slot is
+ *         destroyed before the reply is received
  */
 template <typename T>
-T readDBusProperty(sdbusplus::bus::bus& bus, const std::string& service,
-                   const std::string& object, const std::string& intf,
-                   const std::string& prop)
+[[nodiscard]] sdbusplus::slot_t readDBusPropertyAsync(
+    sdbusplus::bus::bus& bus, const std::string& service,
+    const std::string& object, const std::string& intf,
+    const std::string& prop, std::function<void(std::optional<T>)>&& callback)
 {
-    T retVal{};
-    try
-    {
-        auto properties =
-            bus.new_method_call(service.c_str(), object.c_str(),
-                                "org.freedesktop.DBus.Properties", "Get");
-        properties.append(intf);
-        properties.append(prop);
-        auto result = bus.call(properties);
-        result.read(retVal);
-    }
-    catch (const std::exception& ex)
-    {
-        lg2::error(
-            "Failed to get the property:{PROP} interface:{INTF} path:{PATH} ex:{EX}",
-            "PROP", prop, "INTF", intf, "PATH", object, "EX", ex);
-        throw;
-    }
-    return retVal;
+    auto properties = bus.new_method_call(service.c_str(), object.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get");
+    properties.append(intf);
+    properties.append(prop);
+    return bus.call_async(
+        properties, [object, intf, prop, callback = std::move(callback)](
+                        sdbusplus::message::message& reply) {
+                        std::optional<T> retVal;
+                        try
+                        {
+                            if (reply.is_method_error())
+                            {
+                                throw std::runtime_error(
+                                    reply.get_error()->name);
+                            }
+                            T value{};
+                            reply.read(value);
+                            retVal = std::move(value);
+                        }
+                        catch (const std::exception& ex)
+                        {
+                            lg2::error(
+                                "Failed to get the property:{PROP} "
+                                "interface:{INTF} path:{PATH} ex:{EX}",
+                                "PROP", prop, "INTF", intf, "PATH", object,
+                                "EX", ex);
+                        }
+                        callback(std::move(retVal));
+                    });
 }
 
 /**
- * @brief Read D-Bus property to check if host is in running state
+ * @brief Read dump size from the D-Bus object without blocking the event
+ *        loop
+ * @param[in] bus - D-Bus handle
+ * @param[in] objectPath - path of the D-Bus entry object
+ * @param[in] callback - invoked with the dump size, std::nullopt if the size
+ *            could not be read
+ * @return slot of the pending call
+ */
+[[nodiscard]] sdbusplus::slot_t getDumpSizeAsync(
+    sdbusplus::bus::bus& bus, const std::string& objectPath,
+    std::function<void(std::optional<uint64_t>)>&& callback);
+
+/**
+ * @brief Read D-Bus property to check if system is HMC managed without
+ *        blocking the event loop
+ * @detail Read the attribute with the BIOSConfig.Manager GetAttribute
+ *         method, if attribute is not set it will be assumed system is non
+ *         HMC managed system. Assumption is that if it is HMC managed the
+ *         attribute will be set.
+ * @param[in] bus D-Bus handle
+ * @param[in] callback invoked with true if HMC managed else false,
+ *            std::nullopt if the attribute could not be read
+ * @return slot of the pending call
+ */
+[[nodiscard]] sdbusplus::slot_t isSystemHMCManagedAsync(
+    sdbusplus::bus::bus& bus,
+    std::function<void(std::optional<bool>)>&& callback);
+
+/**
+ * @brief Read the HMC managed attribute out of a BIOSConfig.Manager
+ *        PropertiesChanged signal
+ * @details The signal is walked without decoding the BaseBIOSTable, only
+ *          the value of the pvm_hmc_managed attribute is decoded.
+ * @param[in] msg PropertiesChanged signal
+ * @return true if HMC managed else false, std::nullopt if the signal does
+ *         not carry the attribute or the value is not of the expected type
+ */
+std::optional<bool> readHMCManagedChanged(sdbusplus::message::message& msg);
+
+/**
+ * @brief Read D-Bus property to check if host is in running state without
+ *        blocking the event loop
  * @detail Read the Boot.Progress property to determine if host is running.
  * @param[in] bus D-Bus handle
- * @return true if host is running else false
+ * @param[in] callback invoked with true if host is running else false
+ * @return slot of the pending call
+ */
+[[nodiscard]] sdbusplus::slot_t
+    isHostRunningAsync(sdbusplus::bus::bus& bus,
+                       std::function<void(bool)>&& callback);
+
+/**
+ * @brief Read all dump objects and their properties from the dump manager
+ *        in a single call without blocking the event loop
+ * @param[in] bus D-Bus handle
+ * @param[in] callback invoked with the dump objects with their interfaces and
+ *            properties, std::nullopt if the objects could not be read
+ * @return slot of the pending call
  */
-bool isHostRunning(sdbusplus::bus::bus& bus);
+[[nodiscard]] sdbusplus::slot_t getDumpManagedObjectsAsync(
+    sdbusplus::bus::bus& bus,
+    std::function<void(std::optional<ManagedObjectType>)>&& callback);
 
 /**
- * @brief Read avaialble dumps implementing the dump type entry interface
+ * @brief Read avaialble dumps implementing the entry interfaces without
+ *        blocking the event loop
  * @param[in] bus D-Bus handle
- * @param[in] entryIntf identifies type of the dump
- * @return D-Bus object paths
+ * @param[in] interfaces dump entry interfaces
+ * @param[in] callback invoked with the D-Bus object paths, std::nullopt if
+ *            the paths could not be read
+ * @return slot of the pending call
  */
-const std::vector<std::string> getDumpEntryObjPaths(
-    sdbusplus::bus::bus& bus, const std::string& entryIntf);
+[[nodiscard]] sdbusplus::slot_t getDumpEntryObjPathsAsync(
+    sdbusplus::bus::bus& bus, const std::vector<std::string>& interfaces,
+    std::function<void(std::optional<std::vector<std::string>>)>&& callback);
 } // namespace openpower::dump
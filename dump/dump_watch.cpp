@@ -3,6 +3,7 @@
 #include "dump_watch.hpp"
 
 #include "dbus_util.hpp"
+#include "offload_trace.hpp"
 
 #include <fmt/format.h>
 
@@ -11,8 +12,10 @@
 namespace openpower::dump
 {
 using ::openpower::dump::utility::DBusInteracesList;
-using ::openpower::dump::utility::DBusInteracesMap;
 using ::openpower::dump::utility::DBusPropertiesMap;
+using ::openpower::dump::utility::DumpSubtype;
+using ::openpower::dump::utility::toDumpSubtype;
+using ::openpower::dump::utility::toPldmFileType;
 using ::phosphor::logging::level;
 using ::phosphor::logging::log;
 using ::sdbusplus::bus::match::rules::sender;
@@ -32,59 +35,51 @@ DumpWatch::DumpWatch(sdbusplus::bus::bus& bus, HostOffloaderQueue& dumpQueue,
         sdbusplus::bus::match::rules::interfacesRemoved() +
             sdbusplus::bus::match::rules::argNpath(0, entryObjPath),
         [this](auto& msg) { this->interfaceRemoved(msg); });
+
+    // one match for the property changes of all the entries, dispatched to
+    // the in progress dump by object path
+    std::string entryRoot = entryObjPath;
+    if (entryRoot.ends_with('/'))
+    {
+        entryRoot.pop_back();
+    }
+    _entryPropWatch = std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        sdbusplus::bus::match::rules::type::signal() +
+            sdbusplus::bus::match::rules::member("PropertiesChanged") +
+            sdbusplus::bus::match::rules::interface(dbusPropIntf) +
+            sdbusplus::bus::match::rules::path_namespace(entryRoot),
+        [this](auto& msg) { this->propertiesChanged(msg); });
 }
 
 void DumpWatch::interfaceAdded(sdbusplus::message::message& msg)
 {
     try
     {
+        // capture the entry metadata, properties are decoded only for the
+        // dump entries
         sdbusplus::message::object_path objPath;
-        DBusInteracesMap interfaces;
-        msg.read(objPath, interfaces);
-        if (interfaces.find("com.ibm.Dump.Entry.Hostboot") ==
-                interfaces.end() &&
-            interfaces.find("com.ibm.Dump.Entry.Hardware") ==
-                interfaces.end() &&
-            interfaces.find("com.ibm.Dump.Entry.SBE") == interfaces.end() &&
-            interfaces.find("xyz.openbmc_project.Dump.Entry.BMC") ==
-                interfaces.end())
+        DumpEntry entry;
+        if (!readDumpEntryAdded(msg, objPath, entry) ||
+            entry.type != _dumpType)
             return;
         log<level::INFO>(
             fmt::format("Watch interfaceAdded path ({})", objPath.str).c_str());
+        entry.id = getDumpId(objPath, _dumpType);
+        entry.discoveredTime = std::chrono::steady_clock::now();
+        offloadTrace().record(TraceEvent::discovered, entry.id,
+                              entry.fileType);
 
         // check if dump generation is already completed
-        bool isComplete = false;
-        auto iface = interfaces.find(progressIntf);
-        if (iface != interfaces.end())
-        {
-            auto prop = iface->second.find("Status");
-            if (prop != iface->second.end())
-            {
-                auto status = std::get_if<std::string>(&prop->second);
-                if (status != nullptr)
-                {
-                    if (*status == progressComplete)
-                    {
-                        isComplete = true;
-                    }
-                }
-            }
-        }
-        if (isComplete)
+        if (entry.completed)
         {
-            // queue the dump for offloading
-            _dumpQueue.enqueue(objPath, _dumpType);
+            offloadTrace().record(TraceEvent::completed, entry.id,
+                                  entry.fileType);
+            enqueueCompleted(objPath, std::move(entry));
         }
         else
         {
-            _entryPropWatchList.emplace(
-                objPath, std::make_unique<sdbusplus::bus::match_t>(
-                             _bus,
-                             sdbusplus::bus::match::rules::propertiesChanged(
-                                 objPath.str, progressIntf),
-                             [this, objPath](auto& msg) {
-                                 this->propertiesChanged(objPath, msg);
-                             }));
+            addToWatch(objPath, std::move(entry));
         }
     }
     catch (const std::exception& ex)
@@ -103,21 +98,28 @@ void DumpWatch::interfaceRemoved(sdbusplus::message::message& msg)
         sdbusplus::message::object_path objPath;
         DBusInteracesList interfaces;
         msg.read(objPath, interfaces);
-        if (std::find(interfaces.begin(), interfaces.end(),
-                      "com.ibm.Dump.Entry.Hostboot") == interfaces.end() &&
-            std::find(interfaces.begin(), interfaces.end(),
-                      "com.ibm.Dump.Entry.Hardware") == interfaces.end() &&
-            std::find(interfaces.begin(), interfaces.end(),
-                      "com.ibm.Dump.Entry.SBE") == interfaces.end() &&
-            std::find(interfaces.begin(), interfaces.end(),
-                      "xyz.openbmc_project.Dump.Entry.BMC") == interfaces.end())
+        std::optional<DumpSubtype> subtype;
+        for (const auto& intf : interfaces)
+        {
+            if (auto found = toDumpSubtype(intf))
+            {
+                subtype = found;
+            }
+        }
+        if (!subtype)
             return;
         log<level::INFO>(
             fmt::format("Watch interfaceRemoved path ({})", objPath.str)
                 .c_str());
 
-        _dumpQueue.dequeue(objPath);
+        offloadTrace().record(TraceEvent::removed,
+                              getDumpId(objPath, _dumpType),
+                              toPldmFileType(*subtype));
+        // applied to the queue with the other removals of the iteration
+        _dumpQueue.remove(objPath);
         _entryPropWatchList.erase(objPath);
+        // cancel the size read if the dump is removed before the reply
+        _sizeReadList.erase(objPath);
     }
     catch (const std::exception& ex)
     {
@@ -128,33 +130,53 @@ void DumpWatch::interfaceRemoved(sdbusplus::message::message& msg)
     }
 }
 
-void DumpWatch::propertiesChanged(const object_path& objPath,
-                                  sdbusplus::message::message& msg)
+void DumpWatch::propertiesChanged(sdbusplus::message::message& msg)
 {
     try
     {
+        // skip decoding the signal of dumps not being watched
+        const char* objPath = msg.get_path();
+        if (objPath == nullptr)
+        {
+            return;
+        }
+        auto watch = _entryPropWatchList.find(objPath);
+        if (watch == _entryPropWatchList.end())
+        {
+            // offload of a queued dump might be complete
+            if (_dumpQueue.isQueued(objPath))
+            {
+                offloadChanged(objPath, msg);
+            }
+            return;
+        }
+
         std::string interface;
         DBusPropertiesMap propMap;
         msg.read(interface, propMap);
         log<level::INFO>(
-            fmt::format("Watch propertiesChanged object path ({})", objPath.str)
+            fmt::format("Watch propertiesChanged object path ({})", objPath)
                 .c_str());
 
-        bool fcomplete = isDumpProgressCompleted(propMap);
-        if (!fcomplete)
+        DumpEntry& entry = watch->second;
+        updateDumpEntry(entry, interface, propMap);
+        if (!entry.completed)
         {
             log<level::DEBUG>(
                 fmt::format("Watch propertiesChanged object path ({}) "
                             "status is not completed",
-                            objPath.str)
+                            objPath)
                     .c_str());
             return;
         }
 
-        // queue the dump for offloading
-        _dumpQueue.enqueue(objPath, _dumpType);
+        offloadTrace().record(TraceEvent::completed, entry.id,
+                              entry.fileType);
+        object_path path = watch->first;
+        DumpEntry completedEntry = std::move(entry);
+        _entryPropWatchList.erase(watch);
 
-        _entryPropWatchList.erase(objPath);
+        enqueueCompleted(path, std::move(completedEntry));
     }
     catch (const std::exception& ex)
     {
@@ -165,21 +187,70 @@ void DumpWatch::propertiesChanged(const object_path& objPath,
     }
 }
 
-void DumpWatch::addInProgressDumpsToWatch(std::vector<std::string> paths)
+void DumpWatch::offloadChanged(const std::string& objPath,
+                               sdbusplus::message::message& msg)
+{
+    std::string interface;
+    DBusPropertiesMap propMap;
+    msg.read(interface, propMap);
+    if (interface == entryIntf && isDumpOffloaded(propMap))
+    {
+        _dumpQueue.offloadCompleted(objPath);
+    }
+}
+
+void DumpWatch::enqueueCompleted(const object_path& objPath,
+                                 DumpEntry&& entry)
+{
+    if (entry.offloaded)
+    {
+        // offloaded before, the entry is kept by the dump manager
+        log<level::INFO>(
+            fmt::format("Watch dump already offloaded ({})", objPath.str)
+                .c_str());
+        return;
+    }
+    if (entry.size != 0)
+    {
+        // queue the dump for offloading
+        _dumpQueue.enqueue(objPath, entry);
+        return;
+    }
+
+    // size was not seen in the signals, read it once without waiting for
+    // the dump manager which might be busy creating more dumps
+    _sizeReadList.insert_or_assign(
+        objPath.str,
+        getDumpSizeAsync(
+            _bus, objPath,
+            [this, objPath, entry](std::optional<uint64_t> size) mutable {
+                _sizeReadList.erase(objPath.str);
+                if (!size)
+                {
+                    log<level::ERR>(
+                        fmt::format("Watch failed to read dump size ({})",
+                                    objPath.str)
+                            .c_str());
+                    return;
+                }
+                entry.size = *size;
+                _dumpQueue.enqueue(objPath, entry);
+            }));
+}
+
+void DumpWatch::addToWatch(const object_path& objPath, DumpEntry&& entry)
+{
+    _entryPropWatchList.insert_or_assign(objPath.str, std::move(entry));
+}
+
+void DumpWatch::addInProgressDumpsToWatch(
+    std::vector<std::pair<std::string, DumpEntry>> dumps)
 {
     try
     {
-        for (auto& path : paths)
+        for (auto& [path, entry] : dumps)
         {
-            object_path objPath = path;
-            _entryPropWatchList.emplace(
-                objPath, std::make_unique<sdbusplus::bus::match_t>(
-                             _bus,
-                             sdbusplus::bus::match::rules::propertiesChanged(
-                                 objPath.str, progressIntf),
-                             [this, objPath](auto& msg) {
-                                 this->propertiesChanged(objPath, msg);
-                             }));
+            addToWatch(path, std::move(entry));
         }
     }
     catch (const std::exception& ex)
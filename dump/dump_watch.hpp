@@ -6,12 +6,13 @@
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 
 namespace openpower::dump
 {
 
+using ::openpower::dump::utility::DumpEntry;
 using ::openpower::dump::utility::DumpType;
 using ::sdbusplus::message::object_path;
 
@@ -20,6 +21,10 @@ using ::sdbusplus::message::object_path;
  * @brief Add watch on new dump entries created/deleted so as to offload
  * @details Adds watch on the dump progress property for the newly created
  *  dumps. Initiates offload when dump progress property is changed to complete
+ *  The entry metadata received in the signals is kept with the watch and
+ *  passed on to the offload queue. A single property change match on the
+ *  entry object path namespace serves all the in progress dumps, and the
+ *  queued dumps to detect the offload completion.
  */
 class DumpWatch
 {
@@ -43,12 +48,32 @@ class DumpWatch
 
     /**
      * @brief Add all in progress dumps to property watch
-     * @param[in] objects dump object paths
+     * @param[in] dumps dump object paths and the entry metadata
      * @return void
      */
-    void addInProgressDumpsToWatch(std::vector<std::string> paths);
+    void addInProgressDumpsToWatch(
+        std::vector<std::pair<std::string, DumpEntry>> dumps);
+
+    /**
+     * @brief Queue the completed dump for offload
+     * @details If the size of the dump is not known yet it is read from the
+     *  dump entry without blocking the event loop and the dump is queued
+     *  once the size is received.
+     * @param[in] objPath Object path of the dump entry
+     * @param[in] entry entry metadata of the completed dump
+     * @return void
+     */
+    void enqueueCompleted(const object_path& objPath, DumpEntry&& entry);
 
   private:
+    /**
+     * @brief Add the in progress dump to property watch
+     * @param[in] objPath Object path of the dump entry
+     * @param[in] entry entry metadata known so far
+     * @return void
+     */
+    void addToWatch(const object_path& objPath, DumpEntry&& entry);
+
     /**
      * @brief Callback method for creation of dump entry object
      * @param[in] msg response msg from D-Bus request
@@ -64,13 +89,21 @@ class DumpWatch
     void interfaceRemoved(sdbusplus::message::message& msg);
 
     /**
-     * @brief Callback method for property change on the entry object
-     * @param[in] objPath Object path of the dump entry
+     * @brief Callback method for property change on any entry object
      * @param[in] msg response msg from D-Bus request
      * @return void
      */
-    void propertiesChanged(const object_path& objPath,
-                           sdbusplus::message::message& msg);
+    void propertiesChanged(sdbusplus::message::message& msg);
+
+    /**
+     * @brief Property change on a queued dump, complete the offload once
+     *        the dump manager marks the dump offloaded
+     * @param[in] objPath Object path of the dump entry
+     * @param[in] msg PropertiesChanged signal
+     * @return void
+     */
+    void offloadChanged(const std::string& objPath,
+                        sdbusplus::message::message& msg);
 
     /** @brief D-Bus to connect to */
     sdbusplus::bus::bus& _bus;
@@ -87,8 +120,13 @@ class DumpWatch
     /** @brief watch pointer for interfaces removed */
     std::unique_ptr<sdbusplus::bus::match_t> _intfRemWatch;
 
-    /** @brief map of property change request for the corresponding entry */
-    std::map<object_path, std::unique_ptr<sdbusplus::bus::match_t>>
-        _entryPropWatchList;
+    /** @brief watch pointer for property changes of the entry objects */
+    std::unique_ptr<sdbusplus::bus::match_t> _entryPropWatch;
+
+    /** @brief map of in progress dumps and their metadata keyed by path */
+    std::unordered_map<std::string, DumpEntry> _entryPropWatchList;
+
+    /** @brief pending dump size reads of completed dumps keyed by path */
+    std::unordered_map<std::string, sdbusplus::slot_t> _sizeReadList;
 };
 } // namespace openpower::dump
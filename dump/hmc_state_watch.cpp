@@ -8,7 +8,6 @@
 
 namespace openpower::dump
 {
-using ::openpower::dump::utility::DBusPropertiesMap;
 using ::phosphor::logging::level;
 using ::phosphor::logging::log;
 
@@ -32,37 +31,26 @@ void HMCStateWatch::propertyChanged(sdbusplus::message::message& msg)
         return;
     }
 
-    using BiosBaseTableMap =
-        std::map<std::string, std::variant<BaseBIOSTableItemList>>;
-    std::string object;
-    BiosBaseTableMap propMap;
-    msg.read(object, propMap);
-    if (auto it = propMap.find("BaseBIOSTable"); it != propMap.end())
+    try
     {
-        const auto& baseBiosTableItemList =
-            std::get<BaseBIOSTableItemList>(it->second);
-        auto attrIt = baseBiosTableItemList.find("pvm_hmc_managed");
-
-        if (attrIt != baseBiosTableItemList.end())
+        // signals not carrying the attribute, for example pending attribute
+        // changes, are skipped without decoding
+        auto hmcManaged = readHMCManagedChanged(msg);
+        if (!hmcManaged || hmcManaged == _hmcManaged)
         {
-            const auto& attrValue = std::get<5>(attrIt->second);
-
-            if (std::holds_alternative<std::string>(attrValue))
-            {
-                const std::string& strValue = std::get<std::string>(attrValue);
-                if (strValue == "Enabled")
-                {
-                    // if it is hmc managed exit the service
-                    log<level::INFO>("HMC managed system exit the application");
-                    std::exit(0);
-                }
-            }
-            else
-            {
-                log<level::ERR>("Unexpected value type for 'pvm_hmc_managed'");
-                std::exit(0);
-            }
+            return;
         }
+        _hmcManaged = hmcManaged;
+
+        // offload is paused while the system is HMC managed and resumed if
+        // it is changed back
+        _dumpQueue.hmcStateChange(*hmcManaged);
+    }
+    catch (const std::exception& ex)
+    {
+        log<level::ERR>(
+            fmt::format("Failed to read BIOS attribute signal ({})", ex.what())
+                .c_str());
     }
 }
 } // namespace openpower::dump
@@ -4,13 +4,16 @@
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <optional>
+
 namespace openpower::dump
 {
 
 /**
  * @class HMCStateWatch
  * @brief Add watch on HMC state change to offload dumps, DUMPS are offloaded
- * only for non HMC systems
+ * only for non HMC systems, offload is paused while the system is HMC managed
+ * and resumed when it is changed back
  */
 class HMCStateWatch
 {
@@ -45,5 +48,8 @@ class HMCStateWatch
 
     /*@brief watch for hmc state change */
     std::unique_ptr<sdbusplus::bus::match_t> _hmcStatePropWatch;
+
+    /** @brief last HMC managed state received in a signal */
+    std::optional<bool> _hmcManaged;
 };
 } // namespace openpower::dump
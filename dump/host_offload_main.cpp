@@ -1,4 +1,5 @@
-#include "dbus_util.hpp"
+#include "config.h"
+
 #include "offload_manager.hpp"
 
 #include <fmt/format.h>
@@ -7,8 +8,6 @@
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/source/event.hpp>
 
-#include <cstdlib>
-
 using ::phosphor::logging::level;
 using ::phosphor::logging::log;
 
@@ -18,28 +17,12 @@ int main()
     {
         auto bus = sdbusplus::bus::new_default();
         auto event = sdeventplus::Event::get_default();
-        // Changing a system from hmc-managed to non-hmc manged is a disruptive
-        // process (Power off the system, do some clean ups and IPL).
-        // Changing a system from non-hmc managed to hmc-manged can be done at
-        // runtime.
-        // Not creating offloader objects if system is HMC managed
-        // TODO #https://github.com/ibm-openbmc/powervm-handler/issues/8
-        try
-        {
-            if (openpower::dump::isSystemHMCManaged(bus))
-            {
-                log<level::ERR>("HMC managed system exiting the application");
-                return 0;
-            }
-        }
-        catch (const std::exception& ex)
-        {
-            // BIOSconfig manager takes time to set the property so wait for
-            // property change callback method
-            log<level::INFO>("Failed to read 'pvm_hmc_managed' property");
-        }
+        // watches are installed by the manager before the startup reads
+        // are issued, the reads complete once the event loop runs
         openpower::dump::OffloadManager manager(bus, event);
         manager.offload();
+        // claim the name once the metrics object is on the bus
+        bus.request_name(offloadService);
         bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
         return event.loop();
     }
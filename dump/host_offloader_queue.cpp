@@ -3,68 +3,195 @@
 #include "host_offloader_queue.hpp"
 
 #include "dbus_util.hpp"
+#include "offload_trace.hpp"
+#include "pldm_oem_cmds.hpp"
+#include "pldm_transport.hpp"
 #include "send_pldm_cmd.hpp"
+#include "xyz/openbmc_project/Common/error.hpp"
 
 #include <fmt/format.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <phosphor-logging/log.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
 namespace openpower::dump
 {
 using ::openpower::dump::utility::DBusInteracesList;
 using ::phosphor::logging::level;
 using ::phosphor::logging::log;
 using ::sdbusplus::bus::match::rules::sender;
+using ::sdeventplus::source::Enabled;
+using InvalidArgument =
+    sdbusplus::xyz::openbmc_project::Common::Error::InvalidArgument;
+using Unavailable = sdbusplus::xyz::openbmc_project::Common::Error::Unavailable;
 
-constexpr auto timeoutInMilliSeconds = 5000; // 5 sec
+constexpr auto timeoutInMilliSeconds = 5000; // 5 sec initial retry delay
+constexpr uint32_t retryBackoffMaxShift = 6; // up to 320 sec
 
-HostOffloaderQueue::HostOffloaderQueue(sdbusplus::bus::bus& bus,
-                                       sdeventplus::Event& event) :
-    _bus(bus), _event(event), _offloadTimeout(timeoutInMilliSeconds),
-    _offloadTimer(
-        event, std::bind(std::mem_fn(&HostOffloaderQueue::timerExpired), this),
-        _offloadTimeout)
+// delay before trying again when all the PLDM instance IDs are in use
+constexpr auto instanceIdRetryDelay = std::chrono::milliseconds(100);
+
+// number of dumps next in line read ahead while the current dumps transfer
+constexpr size_t readaheadDumps = 2;
+
+// time the host is given to complete an accepted offload, scaled with the
+// dump size at the slowest expected transfer rate
+constexpr auto stallTimeoutBase = std::chrono::minutes(10);
+constexpr uint64_t stallBytesPerSecond = 1024 * 1024; // 1 MiB/s
+
+// delay before a stalled dump is announced again, doubled on every stall
+constexpr auto stallBackoff = std::chrono::minutes(1);
+constexpr uint32_t stallBackoffMaxShift = 5; // up to 32 min
+
+namespace
 {
-    // initally read the value as this app might run after host is started
-    isHostRunning = openpower::dump::isHostRunning(_bus);
-    try
+/**
+ * @brief Time the host is given to complete an accepted offload
+ * @param[in] size - size of the dump
+ * @return offload deadline from the time the offload was accepted
+ */
+std::chrono::steady_clock::duration stallTimeout(uint64_t size)
+{
+    return stallTimeoutBase + std::chrono::seconds(size / stallBytesPerSecond);
+}
+
+/**
+ * @brief Hint the kernel to read the dump file into the page cache, the
+ *        read is started in the background
+ * @param[in] filePath - path of the dump file
+ * @param[in] length - number of bytes from the start of the file to read
+ */
+void prefetchFile(const std::string& filePath, uint64_t length)
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
     {
-        isHMCManagedSystem = openpower::dump::isSystemHMCManaged(_bus);
+        auto errorNumber = errno;
+        log<level::ERR>(fmt::format("Queue failed to open dump file ({}) "
+                                    "for readahead errno ({})",
+                                    filePath, errorNumber)
+                            .c_str());
+        return;
     }
-    catch (const std::exception& ex)
+    int rc = posix_fadvise(fd, 0, static_cast<off_t>(length),
+                           POSIX_FADV_WILLNEED);
+    if (rc != 0)
     {
-        // if failed to read at startup wait for hmc state change message
-        log<level::INFO>(
-            "Failed to read hmc managed property from BIOSConfig manager");
+        log<level::ERR>(
+            fmt::format("Queue readahead of dump file ({}) failed ({})",
+                        filePath, strerror(rc))
+                .c_str());
+    }
+    ::close(fd);
+}
+
+/**
+ * @brief Check if the host rejected the offload for a reason that does not
+ *        go away when the offload is retried
+ * @param[in] completionCode - completion code of the host response
+ * @return true if the dump is not to be announced again
+ */
+bool isPermanentRejection(uint8_t completionCode)
+{
+    switch (completionCode)
+    {
+        case PLDM_ERROR_INVALID_DATA:
+        case PLDM_ERROR_INVALID_LENGTH:
+        case PLDM_ERROR_UNSUPPORTED_PLDM_CMD:
+        case PLDM_ERROR_INVALID_PLDM_TYPE:
+            return true;
+        default:
+            return false;
     }
+}
+} // namespace
 
-    // intially stop the timer, start only when dumps are added to the queue
+HostOffloaderQueue::HostOffloaderQueue(
+    sdbusplus::bus::bus& bus, sdeventplus::Event& event,
+    pldm::Transport& transport, OffloadMetrics& metrics,
+    OffloadJournal& journal, std::chrono::milliseconds responseTimeout) :
+    _bus(bus), _event(event), _transport(transport), _metrics(metrics),
+    _journal(journal),
+    _offloadPolicy(toOffloadPolicy(offloadPolicyName)),
+    _offloadWindow(offloadWindowSize), _offloadTimeout(timeoutInMilliSeconds),
+    _offloadTimer(
+        event, std::bind(std::mem_fn(&HostOffloaderQueue::timerExpired), this)),
+    _offloadDispatch(event,
+                     [this](sdeventplus::source::EventBase&) { offload(); }),
+    _removalDispatch(
+        event, [this](sdeventplus::source::EventBase&) { applyRemovals(); }),
+    _responseTimeout(responseTimeout),
+    _deadlineTimer(
+        event,
+        std::bind(std::mem_fn(&HostOffloaderQueue::deadlineExpired), this))
+{
+    _transport.setResponseHandler([this](const pldm_msg* msg, size_t msgLen) {
+        responseReceived(msg, msgLen);
+    });
+
+    // intially stop dispatching, start only when dumps are added to the queue
     stopTimer();
+    _removalDispatch.set_enabled(Enabled::Off);
 }
 
-void HostOffloaderQueue::startTimer()
+void HostOffloaderQueue::readInitialState()
 {
-    if (!_offloadTimer.isEnabled() && isHostRunning && !isHMCManagedSystem &&
-        !_offloadDumpList.empty())
+    // initally read the value as this app might run after host is started,
+    // offload is held back until the replies are received
+    _hostStateRead = openpower::dump::isHostRunningAsync(
+        _bus, [this](bool isRunning) { hostStateChange(isRunning); });
+    _hmcStateRead = openpower::dump::isSystemHMCManagedAsync(
+        _bus, [this](std::optional<bool> hmcManaged) {
+            if (!hmcManaged)
+            {
+                // BIOSconfig manager takes time to set the property so wait
+                // for hmc state change message
+                log<level::INFO>("Failed to read 'pvm_hmc_managed' property");
+                return;
+            }
+            // offload stays paused while the system is HMC managed, dumps
+            // are still discovered and queued
+            hmcStateChange(*hmcManaged);
+        });
+}
+
+void HostOffloaderQueue::scheduleOffload()
+{
+    if (!isHostRunning || isHMCManagedSystem)
     {
-        log<level::INFO>(
-            fmt::format("Queue start timer host running ({}) hmcmanaged ({})"
-                        "Dumps size  ({})",
-                        isHostRunning, isHMCManagedSystem,
-                        _offloadDumpList.size())
-                .c_str());
-        _offloadTimer.setEnabled(true);
+        if (_offloadTimer.isEnabled() ||
+            _offloadDispatch.get_enabled() != Enabled::Off)
+        {
+            log<level::INFO>(
+                fmt::format("Queue stop offload host running ({}) "
+                            "hmcmanaged ({})",
+                            isHostRunning, isHMCManagedSystem)
+                    .c_str());
+            stopTimer();
+        }
+        return;
     }
-    else if (_offloadTimer.isEnabled() && !isHostRunning)
+
+    // offload window is full or every queued dump is already in offload
+    if (_inProgressList.size() >= _offloadWindow ||
+        _offloadDumpList.size() <= _inProgressList.size())
     {
-        log<level::INFO>("Queue stop timer host is not in running state");
-        stopTimer();
+        return;
     }
-    else if (_offloadTimer.isEnabled() && isHMCManagedSystem)
+
+    // offload failed recently, retry timer will pick up the queue
+    if (_offloadTimer.isEnabled())
     {
-        log<level::INFO>("Queue stop timer system is HMC managed");
-        stopTimer();
+        return;
     }
+
+    _offloadDispatch.set_enabled(Enabled::OneShot);
 }
 
 void HostOffloaderQueue::stopTimer()
@@ -75,35 +202,353 @@ void HostOffloaderQueue::stopTimer()
                     isHostRunning, isHMCManagedSystem, _offloadDumpList.size())
             .c_str());
     _offloadTimer.setEnabled(false);
+    _offloadDispatch.set_enabled(Enabled::Off);
+    _deadlineTimer.setEnabled(false);
 
-    _offloadInProgress = false;
+    for (auto& [path, slot] : _inProgressList)
+    {
+        releaseInstanceId(slot);
+        // offload is abandoned, the dump is to be announced again
+        _journal.requeued(path);
+    }
+    _inProgressList.clear();
+    _backoffList.clear();
+    _readaheadList.clear();
+    _failureStreak = 0;
 }
 
 void HostOffloaderQueue::timerExpired()
 {
-    offload();
+    // retry delay elapsed, offload the next dump from the queue
+    _offloadTimer.setEnabled(false);
+    scheduleOffload();
+}
+
+std::chrono::milliseconds
+    HostOffloaderQueue::retryDelay(uint32_t failures) const
+{
+    return _offloadTimeout *
+           (1U << std::min(failures - 1, retryBackoffMaxShift));
+}
+
+void HostOffloaderQueue::retryLater(const std::string& path)
+{
+    auto queued = _offloadDumpList.find(path);
+    if (queued == _offloadDumpList.end())
+    {
+        return;
+    }
+    auto& dump = queued->second;
+    ++dump.attempts;
+    auto backoff = retryDelay(dump.attempts);
+    _backoffList.insert_or_assign(path,
+                                  std::chrono::steady_clock::now() + backoff);
+
+    // the failure is likely not specific to the dump, hold back the rest of
+    // the queue too, longer with every failure in a row
+    ++_failureStreak;
+    _offloadTimer.restartOnce(retryDelay(_failureStreak));
+    log<level::INFO>(
+        fmt::format("Queue retrying offload ({}) attempts ({}) in ({}) ms "
+                    "failures in a row ({})",
+                    path, dump.attempts, backoff.count(), _failureStreak)
+            .c_str());
+}
+
+void HostOffloaderQueue::releaseInstanceId(OffloadSlot& slot)
+{
+    if (slot.instanceId)
+    {
+        _transport.freeInstanceId(*slot.instanceId);
+        slot.instanceId.reset();
+    }
+}
+
+void HostOffloaderQueue::armDeadlineTimer()
+{
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    for (const auto& [path, slot] : _inProgressList)
+    {
+        if (!deadline || slot.deadline < *deadline)
+        {
+            deadline = slot.deadline;
+        }
+    }
+    for (const auto& [path, retryTime] : _backoffList)
+    {
+        if (!deadline || retryTime < *deadline)
+        {
+            deadline = retryTime;
+        }
+    }
+
+    if (!deadline)
+    {
+        _deadlineTimer.setEnabled(false);
+        return;
+    }
+    auto remaining = std::max(*deadline - std::chrono::steady_clock::now(),
+                              std::chrono::steady_clock::duration::zero());
+    _deadlineTimer.restartOnce(
+        std::chrono::duration_cast<std::chrono::microseconds>(remaining));
+}
+
+void HostOffloaderQueue::responseReceived(const pldm_msg* msg, size_t msgLen)
+{
+    uint16_t fileType = 0;
+    uint32_t fileHandle = 0;
+    uint8_t fileStatus = PLDM_SUCCESS;
+    if (pldm::decodeFileAckReq(msg, msgLen, fileType, fileHandle, fileStatus))
+    {
+        fileAckReceived(fileType, fileHandle, fileStatus);
+        return;
+    }
+
+    uint8_t instanceId = 0;
+    uint8_t completionCode = PLDM_SUCCESS;
+    if (!pldm::decodeNewFileAvailableResp(msg, msgLen, instanceId,
+                                          completionCode))
+    {
+        return;
+    }
+    auto iter = std::find_if(_inProgressList.begin(), _inProgressList.end(),
+                             [instanceId](const auto& entry) {
+                                 return entry.second.instanceId == instanceId;
+                             });
+    if (iter == _inProgressList.end())
+    {
+        // response to a request not sent by us or already timed out
+        return;
+    }
+    std::string path = iter->first;
+    releaseInstanceId(iter->second);
+    trace(completionCode == PLDM_SUCCESS ? TraceEvent::acknowledged
+                                         : TraceEvent::rejected,
+          path, completionCode);
+
+    if (completionCode == PLDM_SUCCESS)
+    {
+        // host accepted, offload completes when the dump entry is removed,
+        // the offload is considered stalled if it is not removed in time
+        auto& dump = _offloadDumpList.at(path);
+        iter->second.accepted = true;
+        iter->second.deadline = std::chrono::steady_clock::now() +
+                                stallTimeout(dump.entry.size);
+        armDeadlineTimer();
+        dump.attempts = 0;
+        _failureStreak = 0;
+        _journal.acknowledged(path);
+        log<level::INFO>(
+            fmt::format("Queue host acknowledged offload ({})", path).c_str());
+
+        // host is reading the dump, get the next dumps into the page cache
+        readahead();
+        return;
+    }
+
+    log<level::ERR>(
+        fmt::format("Queue host rejected offload ({}) completion code ({}) "
+                    "in progress ({})",
+                    path, completionCode, _inProgressList.size())
+            .c_str());
+
+    if (isPermanentRejection(completionCode))
+    {
+        // error, deque the dump from offloading
+        dropFromQueue(path);
+        return;
+    }
+
+    if (_inProgressList.size() > 1)
+    {
+        // host could not take concurrent offloads, fall back to one offload
+        // at a time
+        log<level::INFO>("Queue host rejected concurrent offload, "
+                         "limiting to one offload at a time");
+        _offloadWindow = 1;
+    }
+
+    // keep the dump queued, announce it again after a backoff
+    _inProgressList.erase(iter);
+    _journal.requeued(path);
+    retryLater(path);
+    armDeadlineTimer();
+}
+
+void HostOffloaderQueue::fileAckReceived(uint16_t fileType,
+                                         uint32_t fileHandle,
+                                         uint8_t fileStatus)
+{
+    // match the file to the offloads outstanding with the host
+    auto iter = std::find_if(
+        _inProgressList.begin(), _inProgressList.end(),
+        [this, fileType, fileHandle](const auto& item) {
+            const DumpEntry& entry = _offloadDumpList.at(item.first).entry;
+            return entry.id == fileHandle && entry.fileType == fileType;
+        });
+    if (iter == _inProgressList.end())
+    {
+        return;
+    }
+    if (fileStatus != PLDM_SUCCESS)
+    {
+        // offload is not complete, left to the stall deadline
+        log<level::ERR>(
+            fmt::format("Queue host file ack ({}) status ({})", iter->first,
+                        fileStatus)
+                .c_str());
+        return;
+    }
+    std::string path = iter->first;
+    offloadCompleted(path);
+}
+
+void HostOffloaderQueue::deadlineExpired()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> timedOut;
+    std::vector<std::string> stalled;
+    for (auto iter = _inProgressList.begin(); iter != _inProgressList.end();)
+    {
+        if (iter->second.deadline > now)
+        {
+            ++iter;
+            continue;
+        }
+        if (iter->second.accepted)
+        {
+            // host accepted the offload but did not complete it in time
+            stalled.push_back(iter->first);
+            ++iter;
+            continue;
+        }
+        log<level::ERR>(
+            fmt::format("Queue no response from host for offload ({}) "
+                        "retrying",
+                        iter->first)
+                .c_str());
+        trace(TraceEvent::timedOut, iter->first,
+              iter->second.instanceId.value_or(0));
+        releaseInstanceId(iter->second);
+
+        // keep the dump queued, announce it again after a backoff
+        _journal.requeued(iter->first);
+        timedOut.push_back(iter->first);
+        iter = _inProgressList.erase(iter);
+    }
+    for (const auto& path : stalled)
+    {
+        offloadStalled(path);
+    }
+    std::erase_if(_backoffList,
+                  [now](const auto& item) { return item.second <= now; });
+    for (const auto& path : timedOut)
+    {
+        retryLater(path);
+    }
+    armDeadlineTimer();
+
+    // stalled dumps no longer hold the offload window and dumps might be
+    // out of backoff, offload the next dumps
+    scheduleOffload();
+}
+
+void HostOffloaderQueue::offloadStalled(const std::string& path)
+{
+    _inProgressList.erase(path);
+    auto queued = _offloadDumpList.find(path);
+    if (queued == _offloadDumpList.end())
+    {
+        return;
+    }
+    auto& dump = queued->second;
+    ++_metrics.stalls;
+    trace(TraceEvent::stalled, path, 0);
+    _journal.requeued(path);
+
+    // move the dump behind the rest of the queue
+    _offloadOrder.erase({dump.order, path});
+    ++dump.stalls;
+    dump.order = OffloadOrder{dump.stalls, std::get<1>(dump.order),
+                              std::get<2>(dump.order), ++_sequence};
+    _offloadOrder.emplace(dump.order, path);
+
+    // announce the dump again after the backoff
+    auto backoff = stallBackoff *
+                   (1U << std::min(dump.stalls - 1, stallBackoffMaxShift));
+    _backoffList.insert_or_assign(path,
+                                  std::chrono::steady_clock::now() + backoff);
+    log<level::ERR>(
+        fmt::format("Queue host stalled offloading ({}) stalls ({}) "
+                    "announcing again in ({}) sec",
+                    path, dump.stalls,
+                    std::chrono::duration_cast<std::chrono::seconds>(backoff)
+                        .count())
+            .c_str());
 }
 
 void HostOffloaderQueue::hostStateChange(bool isRunning)
 {
+    // state is known now, a pending initial read would be stale
+    bool initialState = _hostStateRead.has_value();
+    _hostStateRead.reset();
+    if (initialState && !isRunning)
+    {
+        // get ready for the host to start
+        standby();
+    }
     if (isHostRunning != isRunning)
     {
         isHostRunning = isRunning;
         if (isHostRunning)
         {
+            // host might have been updated to a level supporting concurrent
+            // offloads, start again with the configured window
+            _offloadWindow = offloadWindowSize;
+
             // dumps might have been queued while host is not running,
             // offload them
-            startTimer();
+            scheduleOffload();
         }
         else
         {
             stopTimer();
+            standby();
         }
     }
+    resolveRestored();
+}
+
+void HostOffloaderQueue::standby()
+{
+    log<level::INFO>(
+        fmt::format("Queue standby until host is running, dumps queued ({})",
+                    _offloadDumpList.size())
+            .c_str());
+    if (isHMCManagedSystem)
+    {
+        // offload is paused, do not hold instance IDs other PLDM
+        // requesters might need
+        return;
+    }
+    try
+    {
+        _transport.prepare();
+    }
+    catch (const std::exception& ex)
+    {
+        // transport is opened again when the first offload is sent
+        log<level::ERR>(
+            fmt::format("Queue failed to prepare PLDM transport ({})",
+                        ex.what())
+                .c_str());
+    }
 }
 
 void HostOffloaderQueue::hmcStateChange(bool hmcManaged)
 {
+    // state is known now, a pending initial read would be stale
+    _hmcStateRead.reset();
     if (isHMCManagedSystem != hmcManaged)
     {
         isHMCManagedSystem = hmcManaged;
@@ -112,94 +557,417 @@ void HostOffloaderQueue::hmcStateChange(bool hmcManaged)
             // dumps might have been queued while system is HMC managed, offload
             // them
             log<level::INFO>("System changed to non HMC managed");
-            startTimer();
+            if (!isHostRunning && !_hostStateRead)
+            {
+                // get ready for the host to start
+                standby();
+            }
+            scheduleOffload();
         }
         else
         {
-            log<level::INFO>("System changed to HMC managed");
+            // pause offload, the queued dumps are kept to be offloaded if
+            // the system is changed back to non HMC managed
+            log<level::INFO>(
+                fmt::format("System changed to HMC managed, pausing offload "
+                            "of ({}) dumps",
+                            _offloadDumpList.size())
+                    .c_str());
             stopTimer();
+            _transport.release();
         }
     }
+    resolveRestored();
 }
 
 void HostOffloaderQueue::offload()
 {
-    try
+    std::string failedPath;
+    bool permanent = false;
+    for (const auto& [order, path] : _offloadOrder)
     {
-        if (_offloadInProgress)
+        if (_inProgressList.size() >= _offloadWindow)
         {
-            // offload is in progress return
-            return;
+            // offload window is full return
+            break;
         }
-        if (_offloadDumpList.empty())
+        if (_inProgressList.contains(path) || _backoffList.contains(path) ||
+            _removedList.contains(path))
         {
-            // nothing to offload return
-            return;
+            continue;
         }
 
-        auto iter = _offloadDumpList.begin();
-        _offloadObjPath = iter->first;
-        object_path path = _offloadObjPath;
-        char* end;
-        DumpType type = iter->second;
-        uint32_t id;
-        if (type == DumpType::bmc)
-            id = std::stoul(path.filename());
-        else
-            id = std::strtoul(path.filename().c_str(), &end, 16);
-        uint64_t size = getDumpSize(_bus, _offloadObjPath);
-        log<level::INFO>(
-            fmt::format("Queue offload initiating offload ({}) id ({}) "
-                        "type ({}) size ({})",
-                        _offloadObjPath, id, static_cast<uint32_t>(type), size)
-                .c_str());
-        openpower::dump::pldm::sendNewDumpCmd(id, type, size);
-        _offloadInProgress = true;
+        try
+        {
+            offload(path, _offloadDumpList.at(path));
+        }
+        catch (const Unavailable&)
+        {
+            // not a failure of the dump, try again shortly from the event
+            // loop
+            log<level::INFO>("Queue PLDM instance ID not available, retrying");
+            _offloadTimer.restartOnce(instanceIdRetryDelay);
+            break;
+        }
+        catch (const InvalidArgument& ex)
+        {
+            log<level::ERR>(
+                fmt::format("Queue dump ({}) can not be offloaded ({})", path,
+                            ex.what())
+                    .c_str());
+            ++_metrics.sendFailures;
+            failedPath = path;
+            permanent = true;
+            break;
+        }
+        catch (const std::exception& ex)
+        {
+            // PLDM could return error, if the current dump offloading is
+            // deleted do not throw the error to the caller.
+            log<level::ERR>(
+                fmt::format("Queue dump ({}) deleted/pldm error ({})", path,
+                            ex.what())
+                    .c_str());
+            ++_metrics.sendFailures;
+            failedPath = path;
+            break;
+        }
     }
-    catch (const std::exception& ex)
+    armDeadlineTimer();
+
+    if (failedPath.empty())
     {
-        // PLDM could return error, if the current dump offloading is deleted
-        // do not throw the error to the caller.
-        log<level::ERR>(fmt::format("Queue dump ({}) deleted/pldm error ({})",
-                                    _offloadObjPath, ex.what())
-                            .c_str());
+        readahead();
+        return;
+    }
+    if (permanent)
+    {
+        // error, deque the dump from offloading, the next dump is not
+        // affected
+        dropFromQueue(failedPath);
+        return;
+    }
+    // instance ID, transport or host EID could not be had, keep the dump
+    // queued and back off before attempting the queue again
+    retryLater(failedPath);
+    armDeadlineTimer();
+}
 
-        // error, deque the dump from offloading
-        dequeue(_offloadObjPath);
-        _offloadInProgress = false;
+void HostOffloaderQueue::readahead()
+{
+    // dumps sent are read by the host, their pages no longer count against
+    // the budget
+    std::erase_if(_readaheadList, [this](const auto& item) {
+        return !_offloadDumpList.contains(item.first) ||
+               _inProgressList.contains(item.first) ||
+               _removedList.contains(item.first);
+    });
+    uint64_t used = 0;
+    for (const auto& [path, length] : _readaheadList)
+    {
+        used += length;
+    }
+
+    size_t ahead = 0;
+    for (const auto& [order, path] : _offloadOrder)
+    {
+        if (ahead >= readaheadDumps || used >= readaheadBudget)
+        {
+            break;
+        }
+        if (_inProgressList.contains(path) || _backoffList.contains(path) ||
+            _removedList.contains(path))
+        {
+            continue;
+        }
+        ++ahead;
+        const DumpEntry& entry = _offloadDumpList.at(path).entry;
+        if (_readaheadList.contains(path) || entry.filePath.empty())
+        {
+            continue;
+        }
+        auto length = std::min<uint64_t>(entry.size, readaheadBudget - used);
+        prefetchFile(entry.filePath, length);
+        _readaheadList.emplace(path, length);
+        used += length;
     }
 }
 
-void HostOffloaderQueue::enqueue(const object_path& path, DumpType type)
+void HostOffloaderQueue::offload(const std::string& objPath,
+                                 QueuedDump& dump)
+{
+    const DumpEntry& entry = dump.entry;
+    log<level::INFO>(
+        fmt::format("Queue offload initiating offload ({}) id ({}) "
+                    "type ({}) size ({}) in progress ({})",
+                    objPath, entry.id, static_cast<uint32_t>(entry.type),
+                    entry.size, _inProgressList.size())
+            .c_str());
+    OffloadSlot slot;
+    slot.instanceId = openpower::dump::pldm::sendNewDumpCmd(_transport, entry);
+    auto now = std::chrono::steady_clock::now();
+    slot.deadline = now + _responseTimeout;
+    _inProgressList.emplace(objPath, std::move(slot));
+    _journal.sent(objPath);
+
+    if (!dump.sentTime)
+    {
+        _metrics.enqueueToSend.add(now - dump.queuedTime);
+    }
+    dump.sentTime = now;
+}
+
+void HostOffloaderQueue::enqueue(const object_path& path,
+                                 const DumpEntry& entry)
 {
     log<level::INFO>(fmt::format("Queue enqueue dump ({}) size of Q ({})",
                                  path.str, _offloadDumpList.size())
                          .c_str());
-    _offloadDumpList.emplace(path.str, type);
+    if (_offloadDumpList.contains(path.str))
+    {
+        return;
+    }
+
+    insert(path.str, entry);
+    _journal.queued(path.str, entry);
+
+    // new dump ready to offload, dispatch it if offload window is not full
+    scheduleOffload();
+}
+
+void HostOffloaderQueue::restore(const object_path& path,
+                                 const DumpEntry& entry, JournalState state)
+{
+    log<level::INFO>(
+        fmt::format("Queue restore dump ({}) state ({})", path.str,
+                    static_cast<int>(state))
+            .c_str());
+    if (_offloadDumpList.contains(path.str))
+    {
+        return;
+    }
+
+    insert(path.str, entry);
+    if (state != JournalState::queued)
+    {
+        // host might have been told about the dump, decide once the host
+        // and HMC state is known
+        _restoredList.emplace(path.str, state);
+        resolveRestored();
+    }
+    scheduleOffload();
+}
+
+void HostOffloaderQueue::resolveRestored()
+{
+    if (_restoredList.empty() || _hostStateRead || _hmcStateRead)
+    {
+        return;
+    }
+    bool offloading = isHostRunning && !isHMCManagedSystem;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& [path, state] : _restoredList)
+    {
+        auto queued = _offloadDumpList.find(path);
+        if (queued == _offloadDumpList.end())
+        {
+            continue;
+        }
+        if (!offloading)
+        {
+            // host might have restarted or offload is paused, the host is
+            // to be told about the dump again
+            _journal.requeued(path);
+            continue;
+        }
+
+        // host was already told about the dump, wait for the host instead
+        // of announcing it again
+        auto& dump = queued->second;
+        dump.sentTime = now;
+        OffloadSlot slot;
+        if (state == JournalState::acknowledged)
+        {
+            // wait for the dump entry to be removed
+            slot.accepted = true;
+            slot.deadline = now + stallTimeout(dump.entry.size);
+        }
+        else
+        {
+            // response was not received, announce the dump again if it is
+            // not acknowledged in time
+            slot.deadline = now + _responseTimeout;
+        }
+        _inProgressList.emplace(path, std::move(slot));
+    }
+    log<level::INFO>(
+        fmt::format("Queue restored offloads ({}) held ({})",
+                    _restoredList.size(), offloading)
+            .c_str());
+    _restoredList.clear();
+    armDeadlineTimer();
+}
 
-    // new dump ready to offload start timer, if not started
-    startTimer();
+HostOffloaderQueue::QueuedDump&
+    HostOffloaderQueue::insert(const std::string& path, const DumpEntry& entry)
+{
+    auto now = std::chrono::steady_clock::now();
+    _metrics.discoveryToEnqueue.add(now - entry.discoveredTime);
+    OffloadOrder order{0, offloadRank(_offloadPolicy, entry),
+                       entry.completedTime, ++_sequence};
+    auto queued =
+        _offloadDumpList.emplace(path, QueuedDump{entry, order, now, {}}).first;
+    _offloadOrder.emplace(order, path);
+    offloadTrace().record(TraceEvent::enqueued, entry.id, entry.fileType);
+    return queued->second;
 }
 
-void HostOffloaderQueue::dequeue(const object_path& path)
+std::map<DumpSubtype, size_t> HostOffloaderQueue::queueDepth() const
+{
+    std::map<DumpSubtype, size_t> depth;
+    for (const auto& [path, dump] : _offloadDumpList)
+    {
+        ++depth[dump.entry.subtype];
+    }
+    return depth;
+}
+
+void HostOffloaderQueue::trace(TraceEvent event, const std::string& path,
+                               uint8_t detail)
+{
+    if (auto queued = _offloadDumpList.find(path);
+        queued != _offloadDumpList.end())
+    {
+        const DumpEntry& entry = queued->second.entry;
+        offloadTrace().record(event, entry.id, entry.fileType, detail);
+    }
+}
+
+void HostOffloaderQueue::dropFromQueue(const std::string& path)
+{
+    dequeue(path, false);
+}
+
+void HostOffloaderQueue::dequeue(const object_path& path, bool offloaded)
 {
     log<level::INFO>(fmt::format("Queue dequeue ({}) size of Q ({})", path.str,
                                  _offloadDumpList.size())
                          .c_str());
-    if (_offloadObjPath == path) // succesfully offloaded
+    if (removeFromQueue(path.str, offloaded))
     {
+        _journal.removed(path.str);
+    }
+    armDeadlineTimer();
+    afterDequeue();
+}
+
+void HostOffloaderQueue::remove(const object_path& path)
+{
+    if (_removedList.empty())
+    {
+        // first removal of the iteration, hold back any pending offload
+        // until the removals are applied
+        _offloadDispatch.set_enabled(Enabled::Off);
+        _removalDispatch.set_enabled(Enabled::OneShot);
+    }
+    _removedList.insert(path.str);
+}
+
+void HostOffloaderQueue::offloadCompleted(const object_path& path)
+{
+    if (!isQueued(path.str))
+    {
+        return;
+    }
+    log<level::INFO>(
+        fmt::format("Queue host acknowledged transfer ({})", path.str)
+            .c_str());
+    trace(TraceEvent::offloaded, path.str, 0);
+
+    // free the offload slot for the next dump while the dump manager
+    // removes the entry, the later removal finds the dump dequeued
+    dequeue(path, true);
+}
+
+void HostOffloaderQueue::applyRemovals()
+{
+    std::vector<std::string> removed;
+    for (const auto& path : _removedList)
+    {
+        // removal of a dump the host accepted completes its offload, a
+        // dump deleted before that is not offloaded
+        auto slot = _inProgressList.find(path);
+        bool offloaded = slot != _inProgressList.end() && slot->second.accepted;
+        if (removeFromQueue(path, offloaded))
+        {
+            removed.push_back(path);
+        }
+    }
+    _removedList.clear();
+    log<level::INFO>(
+        fmt::format("Queue dequeue removed dumps ({}) size of Q ({})",
+                    removed.size(), _offloadDumpList.size())
+            .c_str());
+    _journal.removed(removed);
+    armDeadlineTimer();
+    afterDequeue();
+}
+
+bool HostOffloaderQueue::removeFromQueue(const std::string& path,
+                                         bool offloaded)
+{
+    if (auto iter = _inProgressList.find(path); iter != _inProgressList.end())
+    {
+        releaseInstanceId(iter->second);
+        _inProgressList.erase(iter);
+    }
+    auto queued = _offloadDumpList.find(path);
+    if (queued == _offloadDumpList.end())
+    {
+        return false;
+    }
+    if (offloaded && queued->second.sentTime)
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto latency = now - *queued->second.sentTime;
+        _metrics.sendToCompletion.add(latency);
+        ++_metrics.dumpsOffloaded;
+        _metrics.bytesOffloaded += queued->second.entry.size;
         log<level::INFO>(
-            fmt::format("Queue offloaded dump completed ({}) ", path.str)
+            fmt::format("Queue offloaded dump completed ({}) queued to "
+                        "completion ({} ms) send to completion ({} ms)",
+                        path, toMilliseconds(now - queued->second.queuedTime),
+                        toMilliseconds(latency))
                 .c_str());
-        _offloadObjPath.clear();
-        _offloadInProgress = false;
     }
-    _offloadDumpList.erase(path);
+    _offloadOrder.erase({queued->second.order, queued->first});
+    _offloadDumpList.erase(queued);
+    _backoffList.erase(path);
+    _readaheadList.erase(path);
+    _restoredList.erase(path);
+    return true;
+}
 
+void HostOffloaderQueue::afterDequeue()
+{
     // if no more dumps to offload stop the timer
     if (_offloadDumpList.empty())
     {
+        log<level::INFO>(
+            fmt::format("Queue offload latency summary offloaded ({}) "
+                        "enqueue to send mean ({} ms) max ({} ms) "
+                        "send to completion mean ({} ms) max ({} ms)",
+                        _metrics.sendToCompletion.count(),
+                        toMilliseconds(_metrics.enqueueToSend.mean()),
+                        toMilliseconds(_metrics.enqueueToSend.max()),
+                        toMilliseconds(_metrics.sendToCompletion.mean()),
+                        toMilliseconds(_metrics.sendToCompletion.max()))
+                .c_str());
         stopTimer();
+        return;
     }
+
+    // offload the next dump in the queue
+    scheduleOffload();
 }
 } // namespace openpower::dump
@@ -1,30 +1,68 @@
 #pragma once
 
+#include "offload_journal.hpp"
+#include "offload_metrics.hpp"
+#include "offload_policy.hpp"
+#include "offload_trace.hpp"
 #include "utility.hpp"
 
+#include <libpldm/base.h>
+
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/clock.hpp>
 #include <sdeventplus/source/event.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <chrono>
 #include <map>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <unordered_set>
 
 namespace openpower::dump
 {
+namespace pldm
+{
+class Transport;
+} // namespace pldm
+
+using ::openpower::dump::utility::DumpEntry;
+using ::openpower::dump::utility::DumpSubtype;
 using ::openpower::dump::utility::DumpType;
 using ::sdbusplus::message::object_path;
 using ::sdeventplus::ClockId::Monotonic;
+using ::sdeventplus::source::Defer;
 using ::sdeventplus::utility::Timer;
 
 /**
  * @class HostOffloaderQueue
  * @brief To queue the dump offload requests to be sent to the host.
- * @details PHYP could not handle multiple dump offload requests at the same
- *          time, queueing the requests and sending when one offload is done
+ * @details Older PHYP levels could not handle multiple dump offload requests
+ *          at the same time, queueing the requests and keeping at most a
+ *          configured window of offloads outstanding. If the host rejects a
+ *          request while more than one is outstanding, the window falls back
+ *          to a single offload until the host is restarted. Queued dumps
+ *          are offloaded in the order of the configured offload policy.
+ *          An accepted offload not completed within a deadline scaled with
+ *          the dump size is considered stalled, the dump is then announced
+ *          again after a backoff, behind the rest of the queue.
+ *          Dumps failing to offload for a transient reason, PLDM resources
+ *          not available, no host response or a host rejection that might
+ *          go away, are kept queued and retried with an exponential backoff.
+ *          Only dumps that can not be offloaded are dropped from the queue.
+ *          Dumps are discovered and queued while the host is not running,
+ *          offload starts once the host reaches OSRunning. While the host
+ *          reads a dump the files of the next dumps are read ahead. An
+ *          offload completes when the host acknowledges the file or the
+ *          dump entry is marked offloaded, or else when it is removed.
  */
 class HostOffloaderQueue
 {
   public:
+    /** @brief Time to wait for the host to respond to an offload request */
+    static constexpr std::chrono::milliseconds defaultResponseTimeout{10000};
+
     HostOffloaderQueue() = delete;
     HostOffloaderQueue(const HostOffloaderQueue&) = delete;
     HostOffloaderQueue& operator=(const HostOffloaderQueue&) = delete;
@@ -36,23 +74,94 @@ class HostOffloaderQueue
      * @brief Constructor
      * @param[in] bus - D-Bus to attach to
      * @param[in] event - event handler
+     * @param[in] transport - PLDM transport session to the host
+     * @param[in] metrics - latencies of the offload pipeline to update
+     * @param[in] journal - journal of the offload state of the queued dumps
+     * @param[in] responseTimeout - time to wait for the host to respond to
+     *            an offload request
      */
-    HostOffloaderQueue(sdbusplus::bus::bus& bus, sdeventplus::Event& event);
+    HostOffloaderQueue(
+        sdbusplus::bus::bus& bus, sdeventplus::Event& event,
+        pldm::Transport& transport, OffloadMetrics& metrics,
+        OffloadJournal& journal,
+        std::chrono::milliseconds responseTimeout = defaultResponseTimeout);
+
+    /**
+     * @brief Number of dumps queued for offload by dump subtype
+     * @return queued dumps including the dumps in offload
+     */
+    std::map<DumpSubtype, size_t> queueDepth() const;
+
+    /** @brief Number of offload requests outstanding with the host */
+    size_t inFlight() const
+    {
+        return _inProgressList.size();
+    }
+
+    /**
+     * @brief Read the initial host and HMC state without blocking the event
+     *        loop, offload is held back until the replies are received
+     * @details To be called once the state change watches are installed so
+     *          that a change after the read is not missed. A state change
+     *          received before the reply takes precedence over the reply.
+     */
+    void readInitialState();
 
     /**
      * @brief Queue the dumps for offloading
      * @param[in] path - D-Bus path of the dump object
-     * @param[in] type - type of the dump to offload
+     * @param[in] entry - metadata of the dump to offload
+     */
+    void enqueue(const object_path& path, const DumpEntry& entry);
+
+    /**
+     * @brief Queue the dump restored from the journal
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] entry - metadata of the dump to offload
+     * @param[in] state - offload state recorded in the journal, a dump
+     *            announced to the host is held in offload if the host is
+     *            running and the system is not HMC managed, it is announced
+     *            again otherwise. The decision is held back until the
+     *            initial host and HMC state is read.
      */
-    void enqueue(const object_path& path, DumpType type);
+    void restore(const object_path& path, const DumpEntry& entry,
+                 JournalState state);
 
     /**
      * @brief DeQueue the dump object from offloading
      *        Dequeue can happen after succesfull offload or when dump objects
      *        are deleted by redfish client
      * @param[in] path - D-Bus path of the dump object
+     * @param[in] offloaded - true if the host completed the offload of the
+     *            dump, the offload is then counted in the metrics
      */
-    void dequeue(const object_path& path);
+    void dequeue(const object_path& path, bool offloaded);
+
+    /**
+     * @brief Dump object removed, the dump is dequeued together with the
+     *        other dumps removed in the same event loop iteration
+     * @details A bulk delete of the dumps is applied to the queue at once,
+     *          the dumps removed are not offloaded in the meantime.
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void remove(const object_path& path);
+
+    /**
+     * @brief Transfer of the dump to the host is acknowledged, the offload
+     *        is complete without waiting for the dump entry to be removed
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void offloadCompleted(const object_path& path);
+
+    /**
+     * @brief Check if the dump is queued for offload
+     * @param[in] path - D-Bus path of the dump object
+     * @return true if the dump is queued and not removed
+     */
+    bool isQueued(const std::string& path) const
+    {
+        return _offloadDumpList.contains(path) && !_removedList.contains(path);
+    }
 
     /**
      * @brief Host state change notification form host state watch
@@ -68,56 +177,300 @@ class HostOffloaderQueue
 
   private:
     /**
-     * @brief Check the states and start the timer for offloading dumps
+     * @brief Check the states and schedule a deferred offload on the event
+     *        loop, stop any pending offload if offloading is not allowed
      */
-    void startTimer();
+    void scheduleOffload();
 
     /**
-     * @brief Stop the timer
+     * @brief Stop the retry timer and any pending deferred offload
      */
     void stopTimer();
 
     /**
-     * @brief Offload the next available dump from the queue
+     * @brief Hold the dumps restored as announced to the host in offload,
+     *        or queue them to be announced again if the host is not running
+     *        or the system is HMC managed, once both states are known
+     */
+    void resolveRestored();
+
+    /**
+     * @brief Host is not running, keep the queue and get the PLDM transport
+     *        ready so that offload starts as soon as the host is running,
+     *        the transport is left alone while the system is HMC managed
+     */
+    void standby();
+
+    /**
+     * @brief Offload request outstanding with the host
+     */
+    struct OffloadSlot
+    {
+        /** @brief PLDM instance ID of the request awaiting host response */
+        std::optional<uint8_t> instanceId;
+
+        /** @brief true once the host accepted the request */
+        bool accepted = false;
+
+        /**
+         * @brief time by which the host must respond to the request, once
+         *        the host accepted the request the time by which the dump
+         *        must be removed
+         */
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    /**
+     * @brief Offload the next available dumps from the queue until the
+     *        offload window is full
      */
     void offload();
 
-    /** @brief timer expired offload any existing dumps */
+    /**
+     * @brief position in the offload order, stall count, policy rank,
+     *        completion time and sequence, dumps that stalled are ordered
+     *        behind the rest
+     */
+    using OffloadOrder = std::tuple<uint32_t, uint64_t, uint64_t, uint64_t>;
+
+    /**
+     * @brief Dump queued for offload
+     */
+    struct QueuedDump
+    {
+        /** @brief dump metadata captured when the dump was queued */
+        DumpEntry entry;
+
+        /** @brief position of the dump in the offload order */
+        OffloadOrder order;
+
+        /** @brief time the dump was queued */
+        std::chrono::steady_clock::time_point queuedTime;
+
+        /** @brief time the last offload request of the dump was sent */
+        std::optional<std::chrono::steady_clock::time_point> sentTime;
+
+        /** @brief number of times the host stalled offloading the dump */
+        uint32_t stalls = 0;
+
+        /** @brief failed offload attempts since the host last accepted it */
+        uint32_t attempts = 0;
+    };
+
+    /**
+     * @brief Read ahead the files of the next dumps to offload into the
+     *        page cache, within the readahead budget
+     */
+    void readahead();
+
+    /**
+     * @brief Send the offload request of the dump to the host
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] dump - dump to offload
+     */
+    void offload(const std::string& path, QueuedDump& dump);
+
+    /**
+     * @brief Add the lifecycle event of the queued dump to the trace
+     * @param[in] event - lifecycle stage
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] detail - PLDM instance ID or completion code
+     */
+    void trace(TraceEvent event, const std::string& path, uint8_t detail);
+
+    /**
+     * @brief Add the dump to the queue in the order of the offload policy
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] entry - metadata of the dump to offload
+     * @return queued dump
+     */
+    QueuedDump& insert(const std::string& path, const DumpEntry& entry);
+
+    /**
+     * @brief Dequeue the dump that failed to offload
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void dropFromQueue(const std::string& path);
+
+    /**
+     * @brief Remove the dump from the queue
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] offloaded - true if the host completed the offload of the
+     *            dump, the offload is then counted in the metrics
+     * @return true if the dump was queued
+     */
+    bool removeFromQueue(const std::string& path, bool offloaded);
+
+    /** @brief Dequeue the dumps removed in the event loop iteration */
+    void applyRemovals();
+
+    /**
+     * @brief Dumps left the queue, offload the next dumps or stop when the
+     *        queue is empty
+     */
+    void afterDequeue();
+
+    /** @brief timer expired retry offloading any existing dumps */
     void timerExpired();
 
+    /**
+     * @brief Delay before retrying after failed attempts, doubled with
+     *        every failure
+     * @param[in] failures - number of failed attempts, at least one
+     * @return retry delay
+     */
+    std::chrono::milliseconds retryDelay(uint32_t failures) const;
+
+    /**
+     * @brief Offload attempt of the dump failed for a transient reason, keep
+     *        the dump queued and retry it after a backoff
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void retryLater(const std::string& path);
+
+    /**
+     * @brief PLDM message received from the host
+     * @param[in] msg - PLDM message
+     * @param[in] msgLen - length of the message including the header
+     */
+    void responseReceived(const pldm_msg* msg, size_t msgLen);
+
+    /**
+     * @brief Host acknowledged the transfer of a file to pldmd
+     * @param[in] fileType - PLDM file type of the file
+     * @param[in] fileHandle - handle of the file, the dump id
+     * @param[in] fileStatus - status of the transfer
+     */
+    void fileAckReceived(uint16_t fileType, uint32_t fileHandle,
+                         uint8_t fileStatus);
+
+    /**
+     * @brief host did not respond to one or more offload requests or did not
+     *        complete one or more accepted offloads in time, or the backoff
+     *        of a stalled dump elapsed
+     */
+    void deadlineExpired();
+
+    /**
+     * @brief Host did not complete the offload of the dump in time, announce
+     *        it again after a backoff behind the rest of the queue
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void offloadStalled(const std::string& path);
+
+    /**
+     * @brief Arm the deadline timer for the earliest offload deadline or end
+     *        of a stall backoff
+     */
+    void armDeadlineTimer();
+
+    /**
+     * @brief Free the instance ID of the outstanding offload request
+     * @param[in] slot - offload request slot
+     */
+    void releaseInstanceId(OffloadSlot& slot);
+
     /** @brief D-Bus to connect to */
     sdbusplus::bus::bus& _bus;
 
     /** @brief sdevent event handle */
     sdeventplus::Event& _event;
 
-    /** @brief map of property change request for the corresponding entry */
-    std::map<std::string, DumpType> _offloadDumpList;
+    /** @brief PLDM transport session used to send offload requests */
+    pldm::Transport& _transport;
+
+    /** @brief latencies of the offload pipeline */
+    OffloadMetrics& _metrics;
+
+    /** @brief journal of the offload state of the queued dumps */
+    OffloadJournal& _journal;
+
+    /** @brief map of dumps queued for offload keyed by object path */
+    std::map<std::string, QueuedDump> _offloadDumpList;
+
+    /** @brief queued dumps in the order they are to be offloaded */
+    std::set<std::pair<OffloadOrder, std::string>> _offloadOrder;
+
+    /** @brief policy deciding the offload order */
+    const OffloadPolicy _offloadPolicy;
+
+    /** @brief sequence number of the last queued dump */
+    uint64_t _sequence = 0;
+
+    /** @brief dump objects currently in offload */
+    std::map<std::string, OffloadSlot> _inProgressList;
+
+    /** @brief stalled or failed dumps held back from offload until the time */
+    std::map<std::string, std::chrono::steady_clock::time_point> _backoffList;
+
+    /**
+     * @brief dumps restored as announced to the host, held until the host
+     *        and HMC state is known, journal state of the dump
+     */
+    std::map<std::string, JournalState> _restoredList;
+
+    /** @brief dumps read ahead and not yet sent, bytes read ahead */
+    std::map<std::string, uint64_t> _readaheadList;
 
-    /** @brief dump object currently in offload */
-    std::string _offloadObjPath;
+    /** @brief dump objects removed, to be dequeued on the next iteration */
+    std::unordered_set<std::string> _removedList;
 
-    /** @brief Flag set when offload is in progress */
-    bool _offloadInProgress = false;
+    /** @brief maximum number of offloads outstanding with the host */
+    size_t _offloadWindow;
 
     /** @brief Flag to indicate whether the host is in running state */
     bool isHostRunning = false;
 
     /** @brief Flag to indicate whether the system is HMC managed */
     bool isHMCManagedSystem = true; // start as hmc managed system
+
+    /** @brief pending initial read of the host state */
+    std::optional<sdbusplus::slot_t> _hostStateRead;
+
+    /** @brief pending initial read of the HMC managed attribute */
+    std::optional<sdbusplus::slot_t> _hmcStateRead;
+
     /**
-     * @brief Attempt dump offload at every 5 seconds
+     * @brief Delay before retrying offload after the first failed attempt
      */
     const std::chrono::milliseconds _offloadTimeout;
 
+    /** @brief offload attempts failed in a row across the queued dumps */
+    uint32_t _failureStreak = 0;
+
     /**
-     * @brief timer is used as for offload/delete do not want to block
-     *  the caller thread. If we get deleteall request, we might assume dump
-     *  offloaded and try offload the next dump, as the next entry
-     *  might have been deleted we will log error and try with next dump.
-     *  This happens as the D-Bus thread blocks all other interfacesRemoved
-     *  callbacks.
+     * @brief retry timer, armed only when an offload attempt fails so that
+     *  a failing PLDM stack is not hammered with the rest of the queue, the
+     *  delay doubles with every failure in a row until an offload is
+     *  accepted by the host. Also armed for a short delay when no PLDM
+     *  instance ID is available, instead of blocking the event loop.
      */
     Timer<Monotonic> _offloadTimer;
+
+    /**
+     * @brief deferred event source used to offload the next dump on the
+     *  next event loop iteration, enabled one shot whenever a dump becomes
+     *  eligible for offload so that the D-Bus callbacks are not blocked.
+     */
+    Defer _offloadDispatch;
+
+    /**
+     * @brief deferred event source used to dequeue the removed dumps at once
+     *  on the next event loop iteration, so that a bulk delete is applied
+     *  to the queue and the journal as one operation.
+     */
+    Defer _removalDispatch;
+
+    /**
+     * @brief Time to wait for the host to respond to an offload request
+     */
+    const std::chrono::milliseconds _responseTimeout;
+
+    /**
+     * @brief timer armed for the earliest deadline of the offloads or end
+     *  of a backoff, on expiry of a response deadline or the deadline of an
+     *  accepted offload the dump is announced again after a backoff.
+     */
+    Timer<Monotonic> _deadlineTimer;
 };
 } // namespace openpower::dump
@@ -0,0 +1,165 @@
+#include "config.h"
+
+#include "metrics_object.hpp"
+
+#include "offload_trace.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cerrno>
+#include <functional>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::entryIntfTable;
+
+namespace
+{
+/**
+ * @brief Histogram buckets of the latency stats
+ * @param[in] stats - latency stats
+ * @return number of latencies in each bucket
+ */
+std::vector<uint64_t> toHistogram(const LatencyStats& stats)
+{
+    const auto& histogram = stats.histogram();
+    return {histogram.begin(), histogram.end()};
+}
+} // namespace
+
+template <auto getter>
+int MetricsObject::getProperty(sd_bus* /*bus*/, const char* /*path*/,
+                               const char* /*intf*/, const char* prop,
+                               sd_bus_message* reply, void* context,
+                               sd_bus_error* /*error*/)
+{
+    try
+    {
+        const auto* self = static_cast<const MetricsObject*>(context);
+        sdbusplus::message::message msg(reply);
+        msg.append(std::invoke(getter, self));
+    }
+    catch (const std::exception& ex)
+    {
+        lg2::error("Failed to read metrics property:{PROP} ex:{EX}", "PROP",
+                   prop, "EX", ex);
+        return -EIO;
+    }
+    return 0;
+}
+
+int MetricsObject::getTrace(sd_bus_message* msg, void* /*context*/,
+                            sd_bus_error* /*error*/)
+{
+    try
+    {
+        sdbusplus::message::message call(msg);
+        auto reply = call.new_method_return();
+        reply.append(offloadTrace().toJson());
+        reply.method_return();
+    }
+    catch (const std::exception& ex)
+    {
+        lg2::error("Failed to return the offload trace ex:{EX}", "EX", ex);
+        return -EIO;
+    }
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t MetricsObject::_vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("QueueDepth", "a{su}",
+                                getProperty<&MetricsObject::queueDepth>),
+    sdbusplus::vtable::property("InFlight", "u",
+                                getProperty<&MetricsObject::inFlight>),
+    sdbusplus::vtable::property("DumpsOffloaded", "t",
+                                getProperty<&MetricsObject::dumpsOffloaded>),
+    sdbusplus::vtable::property("BytesOffloaded", "t",
+                                getProperty<&MetricsObject::bytesOffloaded>),
+    sdbusplus::vtable::property("SendFailures", "t",
+                                getProperty<&MetricsObject::sendFailures>),
+    sdbusplus::vtable::property("Stalls", "t",
+                                getProperty<&MetricsObject::stalls>),
+    sdbusplus::vtable::property("LatencyBucketsMs", "at",
+                                getProperty<&MetricsObject::latencyBucketsMs>),
+    sdbusplus::vtable::property(
+        "DiscoveryToEnqueue", "at",
+        getProperty<&MetricsObject::discoveryToEnqueue>),
+    sdbusplus::vtable::property("EnqueueToSend", "at",
+                                getProperty<&MetricsObject::enqueueToSend>),
+    sdbusplus::vtable::property("SendToCompletion", "at",
+                                getProperty<&MetricsObject::sendToCompletion>),
+    sdbusplus::vtable::method("GetTrace", "", "s", getTrace),
+    sdbusplus::vtable::end()};
+
+MetricsObject::MetricsObject(sdbusplus::bus::bus& bus, const char* objPath,
+                             const HostOffloaderQueue& dumpQueue,
+                             const OffloadMetrics& metrics) :
+    _dumpQueue(dumpQueue), _metrics(metrics),
+    _interface(bus, objPath, metricsIntf, _vtable, this)
+{}
+
+std::map<std::string, uint32_t> MetricsObject::queueDepth() const
+{
+    auto queued = _dumpQueue.queueDepth();
+    std::map<std::string, uint32_t> depth;
+    for (const auto& [intf, subtype] : entryIntfTable)
+    {
+        // dump type name is the last component of the entry interface
+        auto count = queued.find(subtype);
+        depth.emplace(intf.substr(intf.rfind('.') + 1),
+                      count != queued.end() ? count->second : 0);
+    }
+    return depth;
+}
+
+uint32_t MetricsObject::inFlight() const
+{
+    return _dumpQueue.inFlight();
+}
+
+uint64_t MetricsObject::dumpsOffloaded() const
+{
+    return _metrics.dumpsOffloaded;
+}
+
+uint64_t MetricsObject::bytesOffloaded() const
+{
+    return _metrics.bytesOffloaded;
+}
+
+uint64_t MetricsObject::sendFailures() const
+{
+    return _metrics.sendFailures;
+}
+
+uint64_t MetricsObject::stalls() const
+{
+    return _metrics.stalls;
+}
+
+std::vector<uint64_t> MetricsObject::latencyBucketsMs() const
+{
+    std::vector<uint64_t> buckets;
+    for (const auto& bound : latencyBuckets)
+    {
+        buckets.push_back(bound.count());
+    }
+    return buckets;
+}
+
+std::vector<uint64_t> MetricsObject::discoveryToEnqueue() const
+{
+    return toHistogram(_metrics.discoveryToEnqueue);
+}
+
+std::vector<uint64_t> MetricsObject::enqueueToSend() const
+{
+    return toHistogram(_metrics.enqueueToSend);
+}
+
+std::vector<uint64_t> MetricsObject::sendToCompletion() const
+{
+    return toHistogram(_metrics.sendToCompletion);
+}
+} // namespace openpower::dump
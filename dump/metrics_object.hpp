@@ -0,0 +1,106 @@
+#pragma once
+
+#include "host_offloader_queue.hpp"
+#include "offload_metrics.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openpower::dump
+{
+/**
+ * @class MetricsObject
+ * @brief D-Bus object exporting the offload pipeline metrics
+ * @details The properties are read only and are computed when read, the
+ *  offload path only updates the counters in OffloadMetrics. Latency
+ *  histograms are exported as the count of latencies in each bucket, the
+ *  bucket upper bounds are exported in LatencyBucketsMs. The GetTrace method
+ *  returns the lifecycle trace of the recently offloaded dumps.
+ */
+class MetricsObject
+{
+  public:
+    MetricsObject() = delete;
+    MetricsObject(const MetricsObject&) = delete;
+    MetricsObject& operator=(const MetricsObject&) = delete;
+    MetricsObject(MetricsObject&&) = delete;
+    MetricsObject& operator=(MetricsObject&&) = delete;
+    virtual ~MetricsObject() = default;
+
+    /**
+     * @brief Constructor
+     * @param[in] bus - D-Bus to attach to
+     * @param[in] objPath - object path to export the metrics on
+     * @param[in] dumpQueue - queue of the dumps to offload
+     * @param[in] metrics - offload pipeline metrics
+     */
+    MetricsObject(sdbusplus::bus::bus& bus, const char* objPath,
+                  const HostOffloaderQueue& dumpQueue,
+                  const OffloadMetrics& metrics);
+
+  private:
+    /** @brief Number of dumps queued keyed by dump type name */
+    std::map<std::string, uint32_t> queueDepth() const;
+
+    /** @brief Number of offload requests outstanding with the host */
+    uint32_t inFlight() const;
+
+    /** @brief Number of dumps offloaded */
+    uint64_t dumpsOffloaded() const;
+
+    /** @brief Total size of the dumps offloaded */
+    uint64_t bytesOffloaded() const;
+
+    /** @brief Number of offload requests failed to be sent */
+    uint64_t sendFailures() const;
+
+    /** @brief Number of accepted offloads the host did not complete in time */
+    uint64_t stalls() const;
+
+    /** @brief Upper bounds of the latency histogram buckets */
+    std::vector<uint64_t> latencyBucketsMs() const;
+
+    /** @brief Histogram of discovery to enqueue latencies */
+    std::vector<uint64_t> discoveryToEnqueue() const;
+
+    /** @brief Histogram of enqueue to send latencies */
+    std::vector<uint64_t> enqueueToSend() const;
+
+    /** @brief Histogram of send to completion latencies */
+    std::vector<uint64_t> sendToCompletion() const;
+
+    /**
+     * @brief sd-bus property get callback
+     * @details Appends the value returned by the getter to the reply.
+     */
+    template <auto getter>
+    static int getProperty(sd_bus* bus, const char* path, const char* intf,
+                           const char* prop, sd_bus_message* reply,
+                           void* context, sd_bus_error* error);
+
+    /**
+     * @brief sd-bus method callback returning the dump lifecycle trace
+     * @details Replies with the trace records as JSON, oldest record first.
+     */
+    static int getTrace(sd_bus_message* msg, void* context,
+                        sd_bus_error* error);
+
+    /** @brief properties and methods of the metrics interface */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /** @brief queue of the dumps to offload */
+    const HostOffloaderQueue& _dumpQueue;
+
+    /** @brief offload pipeline metrics */
+    const OffloadMetrics& _metrics;
+
+    /** @brief metrics interface registered on the object */
+    sdbusplus::server::interface_t _interface;
+};
+} // namespace openpower::dump
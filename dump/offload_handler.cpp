@@ -3,6 +3,7 @@
 #include "offload_handler.hpp"
 
 #include "dbus_util.hpp"
+#include "offload_trace.hpp"
 #include "utility.hpp"
 
 #include <fmt/format.h>
@@ -11,8 +12,11 @@
 
 namespace openpower::dump
 {
+using ::openpower::dump::utility::DumpEntry;
 using ::openpower::dump::utility::DumpType;
-using ::openpower::dump::utility::ManagedObjectType;
+using ::openpower::dump::utility::toDumpSubtype;
+using ::openpower::dump::utility::toDumpType;
+using ::openpower::dump::utility::toPldmFileType;
 using ::phosphor::logging::level;
 using ::phosphor::logging::log;
 
@@ -24,30 +28,56 @@ OffloadHandler::OffloadHandler(
     _dumpType(dumpType), _dumpWatch(bus, dumpOffloader, entryObjPath, dumpType)
 {}
 
-void OffloadHandler::offload()
+void OffloadHandler::offload(const ManagedObjectType& objects)
 {
     try
     {
-        auto objectPaths = getDumpEntryObjPaths(_bus, _entryIntf);
-        std::vector<std::string> inProgressDumps;
-        for (auto& path : objectPaths)
+        std::vector<std::pair<std::string, DumpEntry>> inProgressDumps;
+        auto discoveredTime = std::chrono::steady_clock::now();
+        for (const auto& [path, interfaces] : objects)
         {
-            bool fcomplete = isDumpProgressCompleted(_bus, path);
-            if (!fcomplete)
+            // classify the dump from the properties already read
+            DumpEntry entry;
+            entry.type = _dumpType;
+            bool isEntry = false;
+            for (const auto& [intf, propMap] : interfaces)
+            {
+                if (auto subtype = toDumpSubtype(intf);
+                    subtype && toDumpType(*subtype) == _dumpType)
+                {
+                    entry.subtype = *subtype;
+                    entry.fileType = toPldmFileType(*subtype);
+                    isEntry = true;
+                }
+                updateDumpEntry(entry, intf, propMap);
+            }
+            if (!isEntry)
+            {
+                // not a dump of the type this object supports
+                continue;
+            }
+            entry.id = getDumpId(path, _dumpType);
+            entry.discoveredTime = discoveredTime;
+            offloadTrace().record(TraceEvent::discovered, entry.id,
+                                  entry.fileType);
+
+            if (!entry.completed)
             {
                 log<level::INFO>(
                     fmt::format("Offloader dump is not"
                                 " completed, adding to watcher ({})",
-                                path)
+                                path.str)
                         .c_str());
-                inProgressDumps.emplace_back(path);
+                inProgressDumps.emplace_back(path, std::move(entry));
                 continue;
             }
+            offloadTrace().record(TraceEvent::completed, entry.id,
+                                  entry.fileType);
             log<level::INFO>(
-                fmt::format("Offloader queue dump to offload ({})", path)
+                fmt::format("Offloader queue dump to offload ({})", path.str)
                     .c_str());
-            // queue the dump for offloading
-            _dumpOffloader.enqueue(path, _dumpType);
+            // queue the dump for offloading, size is read if not set
+            _dumpWatch.enqueueCompleted(path, std::move(entry));
 
         } // end for
 
@@ -9,6 +9,7 @@
 
 namespace openpower::dump
 {
+using ::openpower::dump::utility::ManagedObjectType;
 
 /**
  * @class OffloadHandler
@@ -42,9 +43,9 @@ class OffloadHandler
 
     /**
      * @brief Offload dump by sending request to PLDM
-     * @param[in] existing dump objects
+     * @param[in] objects - existing dump objects with their properties
      */
-    void offload();
+    void offload(const ManagedObjectType& objects);
 
   protected:
     /* @brief sdbusplus DBus bus connection. */
@@ -0,0 +1,331 @@
+#include "offload_journal.hpp"
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <cerrno>
+#include <sstream>
+#include <system_error>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpSubtype;
+using ::openpower::dump::utility::toDumpType;
+using ::openpower::dump::utility::toPldmFileType;
+using ::phosphor::logging::level;
+using ::phosphor::logging::log;
+
+// journal operations, each line is the operation followed by the path
+// Q <path> <id> <subtype> <size> <completion time> [<file path>]
+constexpr char opQueued = 'Q';
+constexpr char opRequeued = 'U'; // U <path>
+constexpr char opSent = 'S';     // S <path>
+constexpr char opAcked = 'A';    // A <path>
+constexpr char opRemoved = 'R';  // R <path>
+
+// lines appended beyond the live dumps before the journal is rewritten
+constexpr size_t compactThreshold = 256;
+
+namespace
+{
+/**
+ * @brief Journal line recording the dump queued for offload
+ * @param[in] path - D-Bus path of the dump object
+ * @param[in] entry - metadata of the dump
+ * @return journal line without the newline
+ */
+std::string queuedLine(const std::string& path, const DumpEntry& entry)
+{
+    auto line = fmt::format("{} {} {} {} {} {}", opQueued, path, entry.id,
+                            static_cast<uint32_t>(entry.subtype), entry.size,
+                            entry.completedTime);
+    if (!entry.filePath.empty())
+    {
+        // last field, the file path is read up to the end of the line
+        line += ' ';
+        line += entry.filePath;
+    }
+    return line;
+}
+
+/**
+ * @brief Write the file and sync it to the storage
+ * @param[in] file - path of the file, replaced if it exists
+ * @param[in] data - content of the file
+ * @return true if the file is written and synced
+ */
+bool writeFile(const std::filesystem::path& file, const std::string& data)
+{
+    int fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size())
+    {
+        auto rc = ::write(fd, data.data() + written, data.size() - written);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        written += rc;
+    }
+    bool synced = written == data.size() && ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+/**
+ * @brief Sync the directory entries to the storage
+ * @param[in] dir - path of the directory
+ */
+void syncDirectory(const std::filesystem::path& dir)
+{
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+    if (::fsync(fd) != 0)
+    {
+        log<level::ERR>(
+            fmt::format("Journal failed to sync ({}) errno ({})",
+                        dir.string(), errno)
+                .c_str());
+    }
+    ::close(fd);
+}
+} // namespace
+
+OffloadJournal::OffloadJournal(const std::filesystem::path& file) : _file(file)
+{
+    load();
+    compact();
+}
+
+void OffloadJournal::load()
+{
+    std::ifstream stream(_file);
+    if (!stream)
+    {
+        return;
+    }
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (stream.eof())
+        {
+            // last line was not completely written
+            break;
+        }
+        ++_lines;
+        std::istringstream fields(line);
+        char op = 0;
+        std::string path;
+        fields >> op >> path;
+        if (op == opQueued)
+        {
+            JournalDump dump;
+            uint32_t subtype = 0;
+            fields >> dump.entry.id >> subtype >> dump.entry.size;
+            if (!fields ||
+                subtype > static_cast<uint32_t>(DumpSubtype::hardware))
+            {
+                continue;
+            }
+            // completion time and file path are not recorded by older
+            // journals
+            fields >> dump.entry.completedTime >> std::ws;
+            std::getline(fields, dump.entry.filePath);
+            dump.entry.subtype = static_cast<DumpSubtype>(subtype);
+            dump.entry.type = toDumpType(dump.entry.subtype);
+            dump.entry.fileType = toPldmFileType(dump.entry.subtype);
+            dump.entry.completed = true;
+            _dumps.insert_or_assign(path, dump);
+            continue;
+        }
+        auto dump = _dumps.find(path);
+        if (dump == _dumps.end())
+        {
+            continue;
+        }
+        switch (op)
+        {
+            case opRequeued:
+                dump->second.state = JournalState::queued;
+                break;
+            case opSent:
+                dump->second.state = JournalState::sent;
+                break;
+            case opAcked:
+                dump->second.state = JournalState::acknowledged;
+                break;
+            case opRemoved:
+                _dumps.erase(dump);
+                break;
+            default:
+                break;
+        }
+    }
+    log<level::INFO>(
+        fmt::format("Journal restored dumps ({})", _dumps.size()).c_str());
+}
+
+void OffloadJournal::queued(const std::string& path, const DumpEntry& entry)
+{
+    JournalDump dump;
+    dump.entry = entry;
+    _dumps.insert_or_assign(path, dump);
+    append(queuedLine(path, entry));
+}
+
+void OffloadJournal::requeued(const std::string& path)
+{
+    setState(path, JournalState::queued, opRequeued);
+}
+
+void OffloadJournal::sent(const std::string& path)
+{
+    setState(path, JournalState::sent, opSent);
+}
+
+void OffloadJournal::acknowledged(const std::string& path)
+{
+    setState(path, JournalState::acknowledged, opAcked);
+}
+
+void OffloadJournal::removed(const std::string& path)
+{
+    if (_dumps.erase(path) != 0)
+    {
+        append(fmt::format("{} {}", opRemoved, path));
+    }
+}
+
+void OffloadJournal::removed(const std::vector<std::string>& paths)
+{
+    std::string lines;
+    size_t count = 0;
+    for (const auto& path : paths)
+    {
+        if (_dumps.erase(path) != 0)
+        {
+            lines += fmt::format("{} {}\n", opRemoved, path);
+            ++count;
+        }
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    if (_lines > _dumps.size() * 2 + compactThreshold && compact())
+    {
+        // the rewritten journal has only the live dumps, the removals need
+        // not be appended
+        return;
+    }
+    if (!_stream.is_open())
+    {
+        return;
+    }
+    _stream << lines << std::flush;
+    _lines += count;
+}
+
+void OffloadJournal::setState(const std::string& path, JournalState state,
+                              char op)
+{
+    auto dump = _dumps.find(path);
+    if (dump == _dumps.end() || dump->second.state == state)
+    {
+        return;
+    }
+    dump->second.state = state;
+    append(fmt::format("{} {}", op, path));
+}
+
+void OffloadJournal::append(const std::string& line)
+{
+    if (_lines > _dumps.size() * 2 + compactThreshold)
+    {
+        compact();
+    }
+    if (!_stream.is_open())
+    {
+        return;
+    }
+    // flush every line so that the journal survives a crash of the
+    // application, lines lost on a power loss only cause the dumps to be
+    // found by the startup scan or announced to the host again
+    _stream << line << '\n' << std::flush;
+    ++_lines;
+}
+
+bool OffloadJournal::compact()
+{
+    // on failure keep appending to the current journal, the journal is
+    // compacted again on a later append
+    auto keepJournal = [this]() {
+        if (!_stream.is_open())
+        {
+            _stream.open(_file, std::ios::app);
+        }
+    };
+    std::error_code ec;
+    std::filesystem::create_directories(_file.parent_path(), ec);
+
+    // write the live dumps to a new file and replace the journal with it
+    std::string lines;
+    for (const auto& [path, dump] : _dumps)
+    {
+        lines += queuedLine(path, dump.entry);
+        lines += '\n';
+        if (dump.state == JournalState::sent)
+        {
+            lines += fmt::format("{} {}\n", opSent, path);
+        }
+        else if (dump.state == JournalState::acknowledged)
+        {
+            lines += fmt::format("{} {}\n", opAcked, path);
+        }
+    }
+    auto tmpFile = _file;
+    tmpFile += ".tmp";
+    if (!writeFile(tmpFile, lines))
+    {
+        log<level::ERR>(
+            fmt::format("Journal failed to write ({})", tmpFile.string())
+                .c_str());
+        keepJournal();
+        return false;
+    }
+    std::filesystem::rename(tmpFile, _file, ec);
+    if (ec)
+    {
+        log<level::ERR>(fmt::format("Journal failed to replace ({}) ec ({})",
+                                    _file.string(), ec.message())
+                            .c_str());
+        keepJournal();
+        return false;
+    }
+    // make the rename durable, otherwise the old journal might be found
+    // after a power loss
+    syncDirectory(_file.parent_path());
+
+    // the stream still refers to the replaced file
+    _stream.close();
+    _lines = _dumps.size();
+    _stream.open(_file, std::ios::app);
+    return true;
+}
+} // namespace openpower::dump
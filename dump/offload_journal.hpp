@@ -0,0 +1,148 @@
+#pragma once
+
+#include "utility.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpEntry;
+
+/**
+ * @brief Offload state of a journaled dump
+ */
+enum class JournalState
+{
+    queued,      // waiting to be offloaded
+    sent,        // offload request sent, host response not received
+    acknowledged // host accepted the offload request
+};
+
+/**
+ * @brief Dump recorded in the journal
+ */
+struct JournalDump
+{
+    /** @brief dump metadata captured when the dump was queued */
+    DumpEntry entry;
+
+    /** @brief offload state of the dump */
+    JournalState state = JournalState::queued;
+};
+
+/**
+ * @class OffloadJournal
+ * @brief Append only journal of the dumps queued for offload
+ * @details Every change to the offload state of a queued dump is appended to
+ *  the journal file as a line, a partially written last line is ignored on
+ *  load. The journal is replayed when the application starts so that the
+ *  queue can be restored without reading the dump properties and the dumps
+ *  already announced to the host are not announced again. The file is
+ *  rewritten with only the live dumps at load and whenever the appended
+ *  lines outgrow the live dumps. The rewritten file is synced to the storage
+ *  before it replaces the journal, appended lines are only flushed to the
+ *  kernel and so survive a crash of the application but not a power loss.
+ */
+class OffloadJournal
+{
+  public:
+    OffloadJournal() = delete;
+    OffloadJournal(const OffloadJournal&) = delete;
+    OffloadJournal& operator=(const OffloadJournal&) = delete;
+    OffloadJournal(OffloadJournal&&) = delete;
+    OffloadJournal& operator=(OffloadJournal&&) = delete;
+    virtual ~OffloadJournal() = default;
+
+    /**
+     * @brief Constructor, replays the journal file
+     * @param[in] file - path of the journal file
+     */
+    explicit OffloadJournal(const std::filesystem::path& file);
+
+    /**
+     * @brief Dump queued for offload
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] entry - metadata of the dump
+     */
+    void queued(const std::string& path, const DumpEntry& entry);
+
+    /**
+     * @brief Offload of the dump stopped, dump is to be offloaded again
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void requeued(const std::string& path);
+
+    /**
+     * @brief Offload request of the dump sent to the host
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void sent(const std::string& path);
+
+    /**
+     * @brief Host accepted the offload request of the dump
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void acknowledged(const std::string& path);
+
+    /**
+     * @brief Dump removed from the offload queue
+     * @param[in] path - D-Bus path of the dump object
+     */
+    void removed(const std::string& path);
+
+    /**
+     * @brief Dumps removed from the offload queue together, the removals
+     *        are written at once
+     * @param[in] paths - D-Bus paths of the dump objects
+     */
+    void removed(const std::vector<std::string>& paths);
+
+    /** @brief dumps recorded in the journal keyed by object path */
+    const std::map<std::string, JournalDump>& dumps() const
+    {
+        return _dumps;
+    }
+
+  private:
+    /** @brief Replay the journal file */
+    void load();
+
+    /**
+     * @brief Change the state of the journaled dump
+     * @param[in] path - D-Bus path of the dump object
+     * @param[in] state - new offload state
+     * @param[in] op - journal operation recording the change
+     */
+    void setState(const std::string& path, JournalState state, char op);
+
+    /**
+     * @brief Append a line to the journal file
+     * @param[in] line - journal line without the newline
+     */
+    void append(const std::string& line);
+
+    /**
+     * @brief Rewrite the journal file with only the live dumps
+     * @return true if the journal is rewritten, false if the lines are
+     *         still appended to the previous journal file
+     */
+    bool compact();
+
+    /** @brief path of the journal file */
+    const std::filesystem::path _file;
+
+    /** @brief journal file opened for appending */
+    std::ofstream _stream;
+
+    /** @brief dumps recorded in the journal keyed by object path */
+    std::map<std::string, JournalDump> _dumps;
+
+    /** @brief number of lines in the journal file */
+    size_t _lines = 0;
+};
+} // namespace openpower::dump
@@ -3,12 +3,38 @@
 #include "offload_manager.hpp"
 
 #include "dbus_util.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace openpower::dump
 {
+using ::openpower::dump::utility::entryIntfTable;
+
+// one instance ID more than the offload window, so that the ID of a request
+// just completed is not reused for the next request
+constexpr size_t reservedInstanceIds = offloadWindowSize + 1;
+
+// delay before the dump objects are read again after a failed read, doubled
+// with every failure in a row
+constexpr auto scanRetryDelay = std::chrono::seconds(1);
+constexpr uint32_t scanRetryMaxShift = 6; // up to 64 sec
+
 OffloadManager::OffloadManager(sdbusplus::bus::bus& bus,
                                sdeventplus::Event& event) :
-    _bus(bus), _dumpQueue(bus, event), _hostStateWatch(bus, _dumpQueue),
-    _hmcStateWatch(bus, _dumpQueue)
+    _bus(bus), _event(event), _journal(offloadJournalPath),
+    _pldmTransport(event, reservedInstanceIds),
+    _dumpQueue(bus, event, _pldmTransport, _metrics, _journal),
+    _metricsObject(bus, metricsObjPath, _dumpQueue, _metrics),
+    _hostStateWatch(bus, _dumpQueue), _hmcStateWatch(bus, _dumpQueue),
+    _scanRetryTimer(event,
+                    std::bind(std::mem_fn(&OffloadManager::scanDumps), this))
 {
     // add bmc dump offload handler to the list of dump types to offload
     std::unique_ptr<OffloadHandler> bmcDump = std::make_unique<OffloadHandler>(
@@ -24,9 +50,114 @@ OffloadManager::OffloadManager(sdbusplus::bus::bus& bus,
 
 void OffloadManager::offload()
 {
-    for (auto& dump : _offloadHandlerList)
+    // watches are already installed, issue the startup reads together
+    _dumpQueue.readInitialState();
+
+    _scanStart = std::chrono::steady_clock::now();
+    if (_journal.dumps().empty())
+    {
+        scanDumps();
+        return;
+    }
+
+    // dumps of the previous run are journaled, read only the paths to find
+    // the dumps still existing
+    std::vector<std::string> interfaces;
+    for (const auto& [intf, subtype] : entryIntfTable)
+    {
+        interfaces.emplace_back(intf);
+    }
+    _dumpPathsRead = getDumpEntryObjPathsAsync(
+        _bus, interfaces,
+        [this](std::optional<std::vector<std::string>> paths) {
+            if (paths && restoreJournal(*paths))
+            {
+                auto latency = std::chrono::steady_clock::now() - _scanStart;
+                _metrics.startupScan.add(latency);
+                lg2::info("Startup restore of dumps:{SIZE} took:{TIME} ms",
+                          "SIZE", paths->size(), "TIME",
+                          toMilliseconds(latency));
+                return;
+            }
+            // dumps not known to the journal exist, read all the dumps
+            scanDumps();
+        });
+}
+
+bool OffloadManager::restoreJournal(const std::vector<std::string>& paths)
+{
+    std::unordered_set<std::string> existing(paths.begin(), paths.end());
+    auto discoveredTime = std::chrono::steady_clock::now();
+
+    // copy, restoring and removing the dumps updates the journal
+    auto journaled = _journal.dumps();
+
+    // restore in the order the dumps completed, the journal is keyed by
+    // path
+    std::vector<std::pair<std::string, JournalDump>> restored(
+        journaled.begin(), journaled.end());
+    std::stable_sort(restored.begin(), restored.end(),
+                     [](const auto& lhs, const auto& rhs) {
+                         return lhs.second.entry.completedTime <
+                                rhs.second.entry.completedTime;
+                     });
+    for (auto& [path, dump] : restored)
     {
-        dump->offload();
+        if (!existing.contains(path))
+        {
+            // dump removed while the application was not running
+            _journal.removed(path);
+            continue;
+        }
+        dump.entry.discoveredTime = discoveredTime;
+        _dumpQueue.restore(path, dump.entry, dump.state);
     }
+    return std::all_of(paths.begin(), paths.end(),
+                       [&journaled](const auto& path) {
+                           return journaled.contains(path);
+                       });
+}
+
+void OffloadManager::scanDumps()
+{
+    // read all dump entries once and let each handler pick its dumps
+    _dumpObjectsRead = getDumpManagedObjectsAsync(
+        _bus, [this](std::optional<ManagedObjectType> objects) {
+            if (!objects)
+            {
+                // dump manager might not be started yet, read again later
+                // instead of failing the service
+                ++_scanFailures;
+                auto delay = scanRetryDelay *
+                             (1U << std::min(_scanFailures - 1,
+                                             scanRetryMaxShift));
+                lg2::error("Failed to read the dumps existing at startup "
+                           "failures:{FAILURES} retry in:{DELAY} s",
+                           "FAILURES", _scanFailures, "DELAY",
+                           delay.count());
+                _scanRetryTimer.restartOnce(delay);
+                return;
+            }
+            _scanFailures = 0;
+            try
+            {
+                for (auto& dump : _offloadHandlerList)
+                {
+                    dump->offload(*objects);
+                }
+                auto latency = std::chrono::steady_clock::now() - _scanStart;
+                _metrics.startupScan.add(latency);
+                lg2::info("Startup scan of dumps:{SIZE} took:{TIME} ms",
+                          "SIZE", objects->size(), "TIME",
+                          toMilliseconds(latency));
+            }
+            catch (const std::exception& ex)
+            {
+                lg2::error("Failed to offload the dumps existing at startup "
+                           "ex:{EX}",
+                           "EX", ex);
+                _event.exit(EXIT_FAILURE);
+            }
+        });
 }
 } // namespace openpower::dump
@@ -3,12 +3,20 @@
 #include "hmc_state_watch.hpp"
 #include "host_offloader_queue.hpp"
 #include "host_state_watch.hpp"
+#include "metrics_object.hpp"
 #include "offload_handler.hpp"
+#include "offload_journal.hpp"
+#include "offload_metrics.hpp"
+#include "pldm_utils.hpp"
 
 #include <sdbusplus/bus.hpp>
+#include <sdeventplus/clock.hpp>
 #include <sdeventplus/source/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
+#include <chrono>
 #include <memory>
+#include <optional>
 
 namespace openpower::dump
 {
@@ -37,16 +45,53 @@ class OffloadManager
 
     /**
      * @brief Offload dumps existing on the system by sending PLDM request
+     * @details The host state, HMC state and the dump objects are read
+     *  concurrently on the event loop, the watches are installed by the
+     *  constructor so no change is missed while the replies are pending.
+     *  Offload starts as soon as the host is known to be running on a non
+     *  HMC managed system and a dump is queued. If the dumps of the previous
+     *  run are in the journal, only the dump paths are read and the dumps
+     *  are restored from the journal, all the dump objects are read only if
+     *  a dump not in the journal exists.
      */
     void offload();
 
   private:
+    /**
+     * @brief Read all the dump objects and offload the completed dumps, the
+     *        read is retried with a backoff if the dump manager does not
+     *        reply, as it might not be started yet
+     */
+    void scanDumps();
+
+    /**
+     * @brief Restore the journaled dumps still existing to the queue
+     * @param[in] paths - paths of the dump entries existing
+     * @return true if every existing dump was restored from the journal
+     */
+    bool restoreJournal(const std::vector<std::string>& paths);
+
     /** @brief D-Bus to connect to */
     sdbusplus::bus::bus& _bus;
 
+    /** @brief sdevent event handle */
+    sdeventplus::Event& _event;
+
+    /** @brief latencies of the offload pipeline */
+    OffloadMetrics _metrics;
+
+    /** @brief journal of the offload state of the queued dumps */
+    OffloadJournal _journal;
+
+    /** @brief PLDM transport session to the host, kept open across offloads */
+    pldm::PLDMTransport _pldmTransport;
+
     /** @brief Queue to offload dump requests */
     HostOffloaderQueue _dumpQueue;
 
+    /*@brief offload metrics exported on D-Bus */
+    MetricsObject _metricsObject;
+
     /*@brief list of dump offload objects */
     std::vector<std::unique_ptr<OffloadHandler>> _offloadHandlerList;
 
@@ -55,5 +100,20 @@ class OffloadManager
 
     /*@brief watch for HMC state change */
     HMCStateWatch _hmcStateWatch;
+
+    /*@brief pending read of the dump objects existing at startup */
+    std::optional<sdbusplus::slot_t> _dumpObjectsRead;
+
+    /*@brief pending read of the dump paths existing at startup */
+    std::optional<sdbusplus::slot_t> _dumpPathsRead;
+
+    /*@brief time the startup scan started */
+    std::chrono::steady_clock::time_point _scanStart;
+
+    /*@brief failed reads of the dump objects in a row */
+    uint32_t _scanFailures = 0;
+
+    /*@brief timer to read the dump objects again after a failed read */
+    Timer<Monotonic> _scanRetryTimer;
 };
 } // namespace openpower::dump
@@ -0,0 +1,31 @@
+#include "offload_metrics.hpp"
+
+namespace openpower::dump
+{
+void LatencyStats::add(Duration latency)
+{
+    if (_count == 0 || latency < _min)
+    {
+        _min = latency;
+    }
+    if (latency > _max)
+    {
+        _max = latency;
+    }
+    _total += latency;
+    ++_count;
+
+    auto bucket = std::lower_bound(latencyBuckets.begin(), latencyBuckets.end(),
+                                   latency);
+    ++_histogram[std::distance(latencyBuckets.begin(), bucket)];
+}
+
+LatencyStats::Duration LatencyStats::mean() const
+{
+    if (_count == 0)
+    {
+        return Duration::zero();
+    }
+    return _total / _count;
+}
+} // namespace openpower::dump
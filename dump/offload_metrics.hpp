@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace openpower::dump
+{
+/**
+ * @brief Upper bounds of the latency histogram buckets, the last bucket of
+ *        the histogram counts the latencies above the largest bound
+ */
+constexpr std::array<std::chrono::milliseconds, 12> latencyBuckets{
+    std::chrono::milliseconds(10),  std::chrono::milliseconds(100),
+    std::chrono::milliseconds(500), std::chrono::seconds(1),
+    std::chrono::seconds(5),        std::chrono::seconds(10),
+    std::chrono::seconds(30),       std::chrono::minutes(1),
+    std::chrono::minutes(5),        std::chrono::minutes(15),
+    std::chrono::minutes(30),       std::chrono::hours(1)};
+
+/**
+ * @class LatencyStats
+ * @brief Count, minimum, maximum and total of the latencies measured for a
+ *        stage of the offload pipeline
+ */
+class LatencyStats
+{
+  public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    /**
+     * @brief Add a measured latency
+     * @param[in] latency - time spent in the stage
+     */
+    void add(Duration latency);
+
+    /** @brief number of latencies measured */
+    uint64_t count() const
+    {
+        return _count;
+    }
+
+    /** @brief smallest latency measured */
+    Duration min() const
+    {
+        return _min;
+    }
+
+    /** @brief largest latency measured */
+    Duration max() const
+    {
+        return _max;
+    }
+
+    /** @brief mean of the latencies measured */
+    Duration mean() const;
+
+    /** @brief number of latencies measured in each histogram bucket */
+    const std::array<uint64_t, latencyBuckets.size() + 1>& histogram() const
+    {
+        return _histogram;
+    }
+
+  private:
+    /** @brief number of latencies measured */
+    uint64_t _count = 0;
+
+    /** @brief sum of the latencies measured */
+    Duration _total = Duration::zero();
+
+    /** @brief smallest latency measured */
+    Duration _min = Duration::zero();
+
+    /** @brief largest latency measured */
+    Duration _max = Duration::zero();
+
+    /** @brief number of latencies measured in each histogram bucket */
+    std::array<uint64_t, latencyBuckets.size() + 1> _histogram{};
+};
+
+/**
+ * @brief Latencies of the offload pipeline stages
+ */
+struct OffloadMetrics
+{
+    /** @brief startup read of the existing dumps until they are queued */
+    LatencyStats startupScan;
+
+    /** @brief dump entry discovered until the completed dump is queued */
+    LatencyStats discoveryToEnqueue;
+
+    /** @brief dump queued until the offload request is first sent */
+    LatencyStats enqueueToSend;
+
+    /**
+     * @brief offload request sent until the offload completes, the transfer
+     *        is acknowledged or the dump entry is removed
+     */
+    LatencyStats sendToCompletion;
+
+    /** @brief number of dumps offloaded */
+    uint64_t dumpsOffloaded = 0;
+
+    /** @brief total size of the dumps offloaded */
+    uint64_t bytesOffloaded = 0;
+
+    /** @brief number of offload requests failed to be sent */
+    uint64_t sendFailures = 0;
+
+    /** @brief number of accepted offloads the host did not complete in time */
+    uint64_t stalls = 0;
+};
+
+/**
+ * @brief Convert the latency to milliseconds for logging
+ * @param[in] latency - latency to convert
+ * @return latency in milliseconds
+ */
+inline int64_t toMilliseconds(LatencyStats::Duration latency)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(latency)
+        .count();
+}
+} // namespace openpower::dump
@@ -0,0 +1,57 @@
+#include "offload_policy.hpp"
+
+#include <fmt/format.h>
+
+#include <phosphor-logging/log.hpp>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpSubtype;
+using ::phosphor::logging::level;
+using ::phosphor::logging::log;
+
+OffloadPolicy toOffloadPolicy(const std::string& name)
+{
+    if (name == "smallest-first")
+    {
+        return OffloadPolicy::smallestFirst;
+    }
+    if (name == "type-priority")
+    {
+        return OffloadPolicy::typePriority;
+    }
+    if (name != "fifo")
+    {
+        log<level::ERR>(
+            fmt::format("Unknown offload policy ({}) using fifo", name)
+                .c_str());
+    }
+    return OffloadPolicy::fifo;
+}
+
+uint64_t offloadRank(OffloadPolicy policy, const DumpEntry& entry)
+{
+    switch (policy)
+    {
+        case OffloadPolicy::smallestFirst:
+            return entry.size;
+        case OffloadPolicy::typePriority:
+            // hostboot and SBE dumps carry the host failure data service
+            // needs first, large hardware dumps go last
+            switch (entry.subtype)
+            {
+                case DumpSubtype::sbe:
+                case DumpSubtype::hostboot:
+                    return 0;
+                case DumpSubtype::bmc:
+                    return 1;
+                case DumpSubtype::hardware:
+                default:
+                    return 2;
+            }
+        case OffloadPolicy::fifo:
+        default:
+            return 0;
+    }
+}
+} // namespace openpower::dump
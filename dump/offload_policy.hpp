@@ -0,0 +1,38 @@
+#pragma once
+
+#include "utility.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpEntry;
+
+/**
+ * @brief Order in which queued dumps are offloaded to the host
+ */
+enum class OffloadPolicy
+{
+    fifo,          // in the order dumps completed
+    smallestFirst, // smallest dump first
+    typePriority   // hostboot/SBE, then BMC, then hardware dumps
+};
+
+/**
+ * @brief Convert the configured policy name to the offload policy
+ * @param[in] name - policy name, fifo, smallest-first or type-priority
+ * @return offload policy, fifo if the name is not known
+ */
+OffloadPolicy toOffloadPolicy(const std::string& name);
+
+/**
+ * @brief Rank of the dump in the offload queue, dumps with lower rank are
+ *        offloaded first and dumps with the same rank in the order they
+ *        completed, Progress.CompletedTime and then the queue order
+ * @param[in] policy - offload policy
+ * @param[in] entry - dump queued for offload
+ * @return rank of the dump
+ */
+uint64_t offloadRank(OffloadPolicy policy, const DumpEntry& entry);
+} // namespace openpower::dump
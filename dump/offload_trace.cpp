@@ -0,0 +1,85 @@
+#include "offload_trace.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+namespace openpower::dump
+{
+namespace
+{
+/**
+ * @brief Name of the lifecycle stage
+ * @param[in] event - lifecycle stage
+ * @return stage name
+ */
+const char* toString(TraceEvent event)
+{
+    switch (event)
+    {
+        case TraceEvent::discovered:
+            return "discovered";
+        case TraceEvent::completed:
+            return "completed";
+        case TraceEvent::enqueued:
+            return "enqueued";
+        case TraceEvent::sent:
+            return "sent";
+        case TraceEvent::acknowledged:
+            return "acknowledged";
+        case TraceEvent::rejected:
+            return "rejected";
+        case TraceEvent::timedOut:
+            return "timedOut";
+        case TraceEvent::stalled:
+            return "stalled";
+        case TraceEvent::offloaded:
+            return "offloaded";
+        case TraceEvent::removed:
+            return "removed";
+    }
+    return "unknown";
+}
+} // namespace
+
+void OffloadTrace::record(TraceEvent event, uint32_t dumpId,
+                          pldm_fileio_file_type fileType, uint8_t detail)
+{
+    auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    _records[_next] = {static_cast<uint64_t>(now.count()), dumpId,
+                       static_cast<uint16_t>(fileType), event, detail};
+    _next = (_next + 1) % _records.size();
+    if (_size < _records.size())
+    {
+        ++_size;
+    }
+}
+
+std::string OffloadTrace::toJson() const
+{
+    std::string json = "[";
+    size_t first = (_next + _records.size() - _size) % _records.size();
+    for (size_t count = 0; count < _size; ++count)
+    {
+        const auto& rec = _records[(first + count) % _records.size()];
+        if (count != 0)
+        {
+            json += ',';
+        }
+        json += fmt::format(
+            "{{\"timestamp\":{},\"id\":{},\"fileType\":{},\"event\":\"{}\","
+            "\"detail\":{}}}",
+            rec.timestamp, rec.dumpId, rec.fileType, toString(rec.event),
+            rec.detail);
+    }
+    json += ']';
+    return json;
+}
+
+OffloadTrace& offloadTrace()
+{
+    static OffloadTrace trace;
+    return trace;
+}
+} // namespace openpower::dump
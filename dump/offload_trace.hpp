@@ -0,0 +1,94 @@
+#pragma once
+
+#include <libpldm/oem/ibm/file_io.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace openpower::dump
+{
+/**
+ * @brief Stage of the dump offload lifecycle
+ */
+enum class TraceEvent : uint8_t
+{
+    discovered,   // dump entry seen, InterfacesAdded or startup scan
+    completed,    // dump entry progress status completed
+    enqueued,     // dump queued for offload
+    sent,         // NewFileAvailable sent to the host
+    acknowledged, // host accepted the offload request
+    rejected,     // host rejected the offload request
+    timedOut,     // host did not respond to the offload request
+    stalled,      // host did not complete the accepted offload in time
+    offloaded,    // host acknowledged the transfer of the dump
+    removed       // dump entry removed, InterfacesRemoved
+};
+
+/**
+ * @brief Lifecycle trace record of a dump
+ */
+struct TraceRecord
+{
+    /** @brief monotonic time of the event in microseconds */
+    uint64_t timestamp;
+
+    /** @brief dump id */
+    uint32_t dumpId;
+
+    /** @brief PLDM file type identifying the type of the dump */
+    uint16_t fileType;
+
+    /** @brief lifecycle stage */
+    TraceEvent event;
+
+    /** @brief event detail, PLDM instance ID or completion code */
+    uint8_t detail;
+};
+
+/** @brief number of records kept in the trace, oldest records overwritten */
+constexpr size_t traceRecords = 1024;
+
+/**
+ * @class OffloadTrace
+ * @brief Fixed size ring buffer of the dump lifecycle trace records
+ * @details Recording does not allocate, the records are only formatted when
+ *  the trace is read.
+ */
+class OffloadTrace
+{
+  public:
+    /**
+     * @brief Add a record to the trace
+     * @param[in] event - lifecycle stage
+     * @param[in] dumpId - dump id
+     * @param[in] fileType - PLDM file type of the dump
+     * @param[in] detail - PLDM instance ID or completion code
+     */
+    void record(TraceEvent event, uint32_t dumpId,
+                pldm_fileio_file_type fileType, uint8_t detail = 0);
+
+    /**
+     * @brief Trace records as JSON, oldest record first
+     * @return JSON array of the trace records
+     */
+    std::string toJson() const;
+
+  private:
+    /** @brief trace records */
+    std::array<TraceRecord, traceRecords> _records{};
+
+    /** @brief index of the next record to write */
+    size_t _next = 0;
+
+    /** @brief number of records written, up to the size of the trace */
+    size_t _size = 0;
+};
+
+/**
+ * @brief Lifecycle trace of the dumps offloaded by this application
+ * @return trace instance
+ */
+OffloadTrace& offloadTrace();
+} // namespace openpower::dump
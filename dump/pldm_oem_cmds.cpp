@@ -1,6 +1,7 @@
 #include "pldm_oem_cmds.hpp"
 
-#include "pldm_utils.hpp"
+#include "offload_trace.hpp"
+#include "pldm_transport.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <fmt/core.h>
@@ -13,63 +14,31 @@
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 
-#include <fstream>
-
 namespace openpower::dump::pldm
 {
 using namespace phosphor::logging;
 
-constexpr auto eidPath = "/usr/share/pldm/host_eid";
-constexpr mctp_eid_t defaultEIDValue = 9;
-
-PLDMInstanceManager instanceManager;
 using NotAllowed = sdbusplus::xyz::openbmc_project::Common::Error::NotAllowed;
 using Reason = xyz::openbmc_project::Common::NotAllowed::REASON;
+using InvalidArgument =
+    sdbusplus::xyz::openbmc_project::Common::Error::InvalidArgument;
+using Argument = xyz::openbmc_project::Common::InvalidArgument;
+using Unavailable = sdbusplus::xyz::openbmc_project::Common::Error::Unavailable;
 
-namespace internal
-{
-mctp_eid_t readEID()
-{
-    mctp_eid_t eid(defaultEIDValue);
-
-    std::ifstream eidFile{eidPath};
-    if (!eidFile.good())
-    {
-        log<level::ERR>("Could not open host EID file");
-        elog<NotAllowed>(Reason("Required host dump action via pldm is not "
-                                "allowed due to mctp end point read failed"));
-    }
-    else
-    {
-        std::string strEid;
-        eidFile >> strEid;
-        if (!strEid.empty())
-        {
-            eid = strtol(strEid.c_str(), nullptr, 10);
-        }
-        else
-        {
-            log<level::ERR>("EID file was empty");
-            elog<NotAllowed>(Reason(
-                "Required host dump action via pldm is not "
-                "allowed due to mctp end point read failed"));
-        }
-    }
-
-    return eid;
-}
-} // namespace internal
-
-void newFileAvailable(uint32_t dumpId, pldm_fileio_file_type pldmDumpType,
-                      uint64_t dumpSize)
+uint8_t newFileAvailable(Transport& transport, uint32_t dumpId,
+                         pldm_fileio_file_type pldmDumpType, uint64_t dumpSize)
 {
     const size_t pldmMsgHdrSize = sizeof(pldm_msg_hdr);
     std::array<uint8_t, pldmMsgHdrSize + PLDM_NEW_FILE_REQ_BYTES>
         newFileAvailReqMsg;
 
-    mctp_eid_t mctpEndPointId = internal::readEID();
-
-    auto pldmInstanceId = getPLDMInstanceID(mctpEndPointId);
+    auto instanceId = transport.allocInstanceId();
+    if (!instanceId)
+    {
+        // all instance IDs are in use, the caller is to try again later
+        elog<Unavailable>();
+    }
+    auto pldmInstanceId = *instanceId;
     log<level::INFO>(
         fmt::format("encode_new_file_req Instance ID ({}) "
                     "DumpID ({}) DumpType ({}) DumpSize({})  ReqMsgSize({})",
@@ -81,39 +50,25 @@ void newFileAvailable(uint32_t dumpId, pldm_fileio_file_type pldmDumpType,
         reinterpret_cast<pldm_msg*>(newFileAvailReqMsg.data()));
     if (retCode != PLDM_SUCCESS)
     {
-        freePLDMInstanceID(pldmInstanceId, mctpEndPointId);
+        transport.freeInstanceId(pldmInstanceId);
         log<level::ERR>(
             fmt::format(
                 "Failed to encode pldm New file req for new dump available "
                 "dumpId({}), pldmDumpType({}),rc({})",
                 dumpId, static_cast<uint16_t>(pldmDumpType), retCode)
                 .c_str());
-        elog<NotAllowed>(Reason(
-            "Acknowledging new file request failed due to encoding error"));
-    }
-
-    retCode = openPLDM(mctpEndPointId);
-    if (retCode < 0)
-    {
-        freePLDMInstanceID(pldmInstanceId, mctpEndPointId);
-        log<level::ERR>(
-            fmt::format("Failed to openPLDM for new dump available "
-                        "dumpId({}), pldmDumpType({}),rc({})",
-                        dumpId, static_cast<uint16_t>(pldmDumpType), retCode)
-                .c_str());
-        elog<NotAllowed>(
-            Reason("Failed to open PLDM for new dump available request"));
+        // request can not be encoded for this dump, retrying does not help
+        elog<InvalidArgument>(
+            Argument::ARGUMENT_NAME("DUMP_ID"),
+            Argument::ARGUMENT_VALUE(std::to_string(dumpId).c_str()));
     }
 
-    pldm_tid_t pldmTID = static_cast<pldm_tid_t>(mctpEndPointId);
-    retCode = pldm_transport_send_msg(pldmTransport, pldmTID,
-                                      newFileAvailReqMsg.data(),
-                                      newFileAvailReqMsg.size());
+    retCode = transport.send(newFileAvailReqMsg.data(),
+                             newFileAvailReqMsg.size());
     if (retCode != PLDM_REQUESTER_SUCCESS)
     {
-        freePLDMInstanceID(pldmInstanceId, mctpEndPointId);
-        pldmClose();
         auto errorNumber = errno;
+        transport.freeInstanceId(pldmInstanceId);
         log<level::ERR>(
             fmt::format(
                 "Failed to send pldm new file request for new dump available, "
@@ -125,9 +80,57 @@ void newFileAvailable(uint32_t dumpId, pldm_fileio_file_type pldmDumpType,
         elog<NotAllowed>(Reason("New file available  via pldm is not "
                                 "allowed due to new file request send failed"));
     }
-    freePLDMInstanceID(pldmInstanceId, mctpEndPointId);
-    pldmClose();
+    // instance ID is held until the host responds to the request
+    offloadTrace().record(TraceEvent::sent, dumpId, pldmDumpType,
+                          pldmInstanceId);
     lg2::info("Done. PLDM message, id: {ID}, RC: {RC}", "ID", pldmInstanceId,
               "RC", retCode);
+    return pldmInstanceId;
+}
+
+bool decodeNewFileAvailableResp(const pldm_msg* msg, size_t msgLen,
+                                uint8_t& instanceId, uint8_t& completionCode)
+{
+    const size_t pldmMsgHdrSize = sizeof(pldm_msg_hdr);
+    if (msgLen < pldmMsgHdrSize || msg->hdr.request ||
+        msg->hdr.type != PLDM_OEM ||
+        msg->hdr.command != PLDM_NEW_FILE_AVAILABLE)
+    {
+        return false;
+    }
+
+    instanceId = msg->hdr.instance_id;
+    int retCode = decode_new_file_resp(msg, msgLen - pldmMsgHdrSize,
+                                       &completionCode);
+    if (retCode != PLDM_SUCCESS)
+    {
+        lg2::error("Failed to decode new file available response, "
+                   "id: {ID}, RC: {RC}",
+                   "ID", instanceId, "RC", retCode);
+        completionCode = PLDM_ERROR;
+    }
+    return true;
+}
+
+bool decodeFileAckReq(const pldm_msg* msg, size_t msgLen, uint16_t& fileType,
+                      uint32_t& fileHandle, uint8_t& fileStatus)
+{
+    const size_t pldmMsgHdrSize = sizeof(pldm_msg_hdr);
+    if (msgLen < pldmMsgHdrSize || !msg->hdr.request ||
+        msg->hdr.type != PLDM_OEM || msg->hdr.command != PLDM_FILE_ACK)
+    {
+        return false;
+    }
+
+    // request is answered by pldmd, it is only observed here
+    int retCode = decode_file_ack_req(msg, msgLen - pldmMsgHdrSize, &fileType,
+                                      &fileHandle, &fileStatus);
+    if (retCode != PLDM_SUCCESS)
+    {
+        lg2::error("Failed to decode file ack request, RC: {RC}", "RC",
+                   retCode);
+        return false;
+    }
+    return true;
 }
 } // namespace openpower::dump::pldm
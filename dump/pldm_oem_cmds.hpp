@@ -5,22 +5,50 @@
 
 namespace openpower::dump::pldm
 {
-namespace internal
-{
-/**
- * @brief Reads the MCTP endpoint ID out of a file
- */
-mctp_eid_t readEID();
-} // namespace internal
+class Transport;
+
 /**
  * @brief Send new file available PLDM command
  *
+ * @param[in] transport - PLDM transport session to the host
  * @param[in] id - Dump id
  * @param[in] dumpType - Type of the dump.
  * @param[in] dumpSize - size of the dump
- * @return NULL
+ * @return PLDM instance ID of the request, the ID is held until the host
+ *         response is received and must be freed by the caller
+ * @throws InvalidArgument if the request can not be encoded for the dump,
+ *         Unavailable if no instance ID is available right now,
+ *         NotAllowed if the request could not be sent
+ *
+ */
+uint8_t newFileAvailable(Transport& transport, uint32_t id,
+                         pldm_fileio_file_type dumpType, uint64_t dumpSize);
+
+/**
+ * @brief Decode new file available PLDM response from the host
+ *
+ * @param[in] msg - PLDM message received from the host
+ * @param[in] msgLen - length of the message including the header
+ * @param[out] instanceId - instance ID of the response
+ * @param[out] completionCode - completion code sent by the host
+ * @return true if the message is a new file available response else false
+ *
+ */
+bool decodeNewFileAvailableResp(const pldm_msg* msg, size_t msgLen,
+                                uint8_t& instanceId, uint8_t& completionCode);
+
+/**
+ * @brief Decode file ack PLDM request sent by the host to pldmd once it has
+ *        transferred a file
+ *
+ * @param[in] msg - PLDM message received from the host
+ * @param[in] msgLen - length of the message including the header
+ * @param[out] fileType - type of the file acknowledged
+ * @param[out] fileHandle - handle of the file, the dump id
+ * @param[out] fileStatus - status of the transfer sent by the host
+ * @return true if the message is a valid file ack request else false
  *
  */
-void newFileAvailable(uint32_t id, pldm_fileio_file_type dumpType,
-                      uint64_t dumpSize);
+bool decodeFileAckReq(const pldm_msg* msg, size_t msgLen, uint16_t& fileType,
+                      uint32_t& fileHandle, uint8_t& fileStatus);
 } // namespace openpower::dump::pldm
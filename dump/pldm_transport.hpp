@@ -0,0 +1,68 @@
+#pragma once
+
+#include <libpldm/instance-id.h>
+#include <libpldm/pldm.h>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+namespace openpower::dump::pldm
+{
+/**
+ * @class Transport
+ * @brief PLDM transport session to the host used to offload the dumps
+ * @details The offload queue sends requests and receives the host messages
+ *          through this interface, so that it does not depend on the
+ *          mctp-demux transport and the instance ID database.
+ */
+class Transport
+{
+  public:
+    /** @brief Callback invoked with each PLDM message received from host */
+    using ResponseHandler = std::function<void(const pldm_msg*, size_t)>;
+
+    virtual ~Transport() = default;
+
+    /**
+     * @brief Register the handler for messages received from the host
+     *
+     * @param[in] handler - callback invoked with each received message
+     */
+    virtual void setResponseHandler(ResponseHandler&& handler) = 0;
+
+    /**
+     * @brief Send a PLDM message to the host
+     *
+     * @param[in] msg - encoded PLDM message
+     * @param[in] msgLen - length of the encoded message
+     * @return PLDM_REQUESTER_SUCCESS on success else requester error code
+     */
+    virtual pldm_requester_rc_t send(const void* msg, size_t msgLen) = 0;
+
+    /**
+     * @brief Get the transport ready ahead of the first request
+     *
+     * @return void, throw exception on failures
+     */
+    virtual void prepare() = 0;
+
+    /** @brief Release the resources held for requests not sent yet */
+    virtual void release() = 0;
+
+    /**
+     * @brief Allocate an instance ID for a request to the host
+     *
+     * @return instance ID, std::nullopt if no instance ID is available
+     *         right now
+     */
+    virtual std::optional<pldm_instance_id_t> allocInstanceId() = 0;
+
+    /**
+     * @brief Free the instance ID once the request is complete
+     *
+     * @param[in] instanceId - instance ID of the request
+     */
+    virtual void freeInstanceId(pldm_instance_id_t instanceId) = 0;
+};
+} // namespace openpower::dump::pldm
@@ -7,12 +7,16 @@
 #include <libpldm/pldm.h>
 #include <libpldm/transport/mctp-demux.h>
 #include <poll.h>
+#include <sys/epoll.h>
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <phosphor-logging/log.hpp>
 #include <pldm_utils.hpp>
 
+#include <cstdlib>
+#include <fstream>
+
 namespace openpower::dump::pldm
 {
 using namespace phosphor::logging;
@@ -61,9 +65,45 @@ std::string getService(sdbusplus::bus::bus& bus, const std::string& path,
 using NotAllowed = sdbusplus::xyz::openbmc_project::Common::Error::NotAllowed;
 using Reason = xyz::openbmc_project::Common::NotAllowed::REASON;
 
+constexpr auto eidPath = "/usr/share/pldm/host_eid";
+constexpr mctp_eid_t defaultEIDValue = 9;
+
 pldm_instance_db* pldmInstanceIdDb = nullptr;
-pldm_transport* pldmTransport = nullptr;
-pldm_transport_mctp_demux* mctpDemux = nullptr;
+PLDMInstanceManager instanceManager;
+
+namespace internal
+{
+mctp_eid_t readEID()
+{
+    mctp_eid_t eid(defaultEIDValue);
+
+    std::ifstream eidFile{eidPath};
+    if (!eidFile.good())
+    {
+        log<level::ERR>("Could not open host EID file");
+        elog<NotAllowed>(Reason("Required host dump action via pldm is not "
+                                "allowed due to mctp end point read failed"));
+    }
+    else
+    {
+        std::string strEid;
+        eidFile >> strEid;
+        if (!strEid.empty())
+        {
+            eid = strtol(strEid.c_str(), nullptr, 10);
+        }
+        else
+        {
+            log<level::ERR>("EID file was empty");
+            elog<NotAllowed>(Reason(
+                "Required host dump action via pldm is not "
+                "allowed due to mctp end point read failed"));
+        }
+    }
+
+    return eid;
+}
+} // namespace internal
 
 PLDMInstanceManager::PLDMInstanceManager()
 {
@@ -95,30 +135,58 @@ void PLDMInstanceManager::destroyPLDMInstanceIdDb()
     }
 }
 
-int openPLDM(mctp_eid_t eid)
+PLDMTransport::PLDMTransport(sdeventplus::Event& event, size_t reservedIds) :
+    _event(event), _reservation(reservedIds)
+{}
+
+PLDMTransport::~PLDMTransport()
+{
+    close();
+    for (auto instanceId : _reservedIds)
+    {
+        freePLDMInstanceID(instanceId, *_eid);
+    }
+}
+
+void PLDMTransport::setResponseHandler(ResponseHandler&& handler)
+{
+    _responseHandler = std::move(handler);
+}
+
+mctp_eid_t PLDMTransport::getEID()
+{
+    if (!_eid)
+    {
+        _eid = internal::readEID();
+    }
+    return *_eid;
+}
+
+int PLDMTransport::open()
 {
-    auto fd = -1;
-    if (pldmTransport)
+    if (_transport)
     {
-        lg2::error("open: pldmTransport already setup!");
-        elog<NotAllowed>(Reason("pldmTransport already setup"));
-        return fd;
+        return _fd;
     }
 
-    fd = openMctpDemuxTransport(eid);
+    auto fd = openMctpDemuxTransport(getEID());
     if (fd < 0)
     {
         auto e = errno;
-        lg2::error("openMctpDemuxTransport failed, errno: {ERRNO}, FD: FD",
+        lg2::error("openMctpDemuxTransport failed, errno: {ERRNO}, FD: {FD}",
                    "ERRNO", e, "FD", fd);
         elog<NotAllowed>(Reason("Failed to opem MCTP demux transport"));
     }
-    return fd;
+    _fd = fd;
+    _ioSource = std::make_unique<sdeventplus::source::IO>(
+        _event, _fd, EPOLLIN,
+        std::bind_front(&PLDMTransport::readMessage, this));
+    return _fd;
 }
 
-int openMctpDemuxTransport(mctp_eid_t eid)
+int PLDMTransport::openMctpDemuxTransport(mctp_eid_t eid)
 {
-    int rc = pldm_transport_mctp_demux_init(&mctpDemux);
+    int rc = pldm_transport_mctp_demux_init(&_mctpDemux);
     if (rc)
     {
         lg2::error(
@@ -127,48 +195,163 @@ int openMctpDemuxTransport(mctp_eid_t eid)
         return rc;
     }
 
-    rc = pldm_transport_mctp_demux_map_tid(mctpDemux, eid, eid);
+    rc = pldm_transport_mctp_demux_map_tid(_mctpDemux, eid, eid);
     if (rc)
     {
         lg2::error(
             "openMctpDemuxTransport: Failed to setup tid to eid mapping. rc = {RC}",
             "RC", rc);
-        pldmClose();
+        close();
         return rc;
     }
-    pldmTransport = pldm_transport_mctp_demux_core(mctpDemux);
+    _transport = pldm_transport_mctp_demux_core(_mctpDemux);
 
     struct pollfd pollfd;
-    rc = pldm_transport_mctp_demux_init_pollfd(pldmTransport, &pollfd);
+    rc = pldm_transport_mctp_demux_init_pollfd(_transport, &pollfd);
     if (rc)
     {
         lg2::error("openMctpDemuxTransport: Failed to get pollfd. rc = {RC}",
                    "RC", rc);
-        pldmClose();
+        close();
         return rc;
     }
     return pollfd.fd;
 }
 
-void pldmClose()
+void PLDMTransport::close()
+{
+    _ioSource.reset();
+    if (_mctpDemux)
+    {
+        pldm_transport_mctp_demux_destroy(_mctpDemux);
+    }
+    _mctpDemux = nullptr;
+    _transport = nullptr;
+    _fd = -1;
+}
+
+void PLDMTransport::prepare()
+{
+    open();
+    reserveInstanceIds();
+}
+
+void PLDMTransport::release()
 {
-    pldm_transport_mctp_demux_destroy(mctpDemux);
-    mctpDemux = nullptr;
-    pldmTransport = nullptr;
+    close();
+    for (auto instanceId : _freeIds)
+    {
+        freePLDMInstanceID(instanceId, getEID());
+        _reservedIds.erase(instanceId);
+    }
+    _freeIds.clear();
+}
+
+void PLDMTransport::reserveInstanceIds()
+{
+    auto tid = getEID();
+    while (_reservedIds.size() < _reservation)
+    {
+        auto instanceId = getPLDMInstanceID(tid);
+        if (!instanceId)
+        {
+            // database is busy, complete the reservation on the next request
+            break;
+        }
+        _reservedIds.insert(*instanceId);
+        _freeIds.push_back(*instanceId);
+    }
+}
+
+std::optional<pldm_instance_id_t> PLDMTransport::allocInstanceId()
+{
+    reserveInstanceIds();
+    if (_freeIds.empty())
+    {
+        return getPLDMInstanceID(getEID());
+    }
+    // reuse the ID freed the longest ago, so that a late response to a
+    // timed out request is not taken for the response to the new request
+    auto instanceId = _freeIds.front();
+    _freeIds.pop_front();
+    return instanceId;
+}
+
+void PLDMTransport::freeInstanceId(pldm_instance_id_t instanceId)
+{
+    if (_reservedIds.contains(instanceId))
+    {
+        _freeIds.push_back(instanceId);
+        return;
+    }
+    freePLDMInstanceID(instanceId, getEID());
+}
+
+pldm_requester_rc_t PLDMTransport::send(const void* msg, size_t msgLen)
+{
+    auto tid = static_cast<pldm_tid_t>(getEID());
+    open();
+    auto rc = pldm_transport_send_msg(_transport, tid, msg, msgLen);
+    if (rc != PLDM_REQUESTER_SUCCESS)
+    {
+        // socket might have gone stale (mctp-demux restart), reconnect and
+        // try once more before reporting the failure
+        lg2::info("PLDM send failed, reconnecting transport rc = {RC}", "RC",
+                  static_cast<int>(rc));
+        close();
+        open();
+        rc = pldm_transport_send_msg(_transport, tid, msg, msgLen);
+    }
+    return rc;
+}
+
+void PLDMTransport::readMessage(sdeventplus::source::IO& source, int /*fd*/,
+                                uint32_t revents)
+{
+    if (revents & (EPOLLERR | EPOLLHUP))
+    {
+        // stop watching, next send failure will re-open the transport
+        lg2::error("PLDM transport socket error, revents = {REVENTS}",
+                   "REVENTS", revents);
+        source.set_enabled(sdeventplus::source::Enabled::Off);
+        return;
+    }
+
+    pldm_tid_t tid = 0;
+    void* msg = nullptr;
+    size_t msgLen = 0;
+    auto rc = pldm_transport_recv_msg(_transport, &tid, &msg, &msgLen);
+    if (rc != PLDM_REQUESTER_SUCCESS)
+    {
+        // mctp-demux delivers traffic of every PLDM requester on the BMC,
+        // messages not meant for us are dropped by the transport
+        return;
+    }
+    std::unique_ptr<void, decltype(&std::free)> msgPtr(msg, &std::free);
+
+    if (_responseHandler && msgLen >= sizeof(pldm_msg_hdr))
+    {
+        try
+        {
+            _responseHandler(static_cast<const pldm_msg*>(msg), msgLen);
+        }
+        catch (const std::exception& ex)
+        {
+            lg2::error("PLDM response handler failed ex:{EX}", "EX", ex);
+        }
+    }
 }
 
-pldm_instance_id_t getPLDMInstanceID(uint8_t tid)
+std::optional<pldm_instance_id_t> getPLDMInstanceID(uint8_t tid)
 {
     pldm_instance_id_t instanceID = 0;
 
     auto rc = pldm_instance_id_alloc(pldmInstanceIdDb, tid, &instanceID);
     if (rc == -EAGAIN)
     {
-        lg2::info(
-            "Failed to get instance id trying again after 100ms, rc = {RC}",
-            "RC", rc);
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        rc = pldm_instance_id_alloc(pldmInstanceIdDb, tid, &instanceID);
+        // caller retries from the event loop instead of blocking it
+        lg2::info("Instance id not available, rc = {RC}", "RC", rc);
+        return std::nullopt;
     }
 
     if (rc)
@@ -1,14 +1,25 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #pragma once
+#include "pldm_transport.hpp"
+
 #include <libpldm/instance-id.h>
 #include <libpldm/pldm.h>
 #include <libpldm/transport.h>
+#include <libpldm/transport/mctp-demux.h>
 #include <unistd.h>
 
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+
 namespace openpower::dump::pldm
 {
-extern struct pldm_transport* pldmTransport;
 class PLDMInstanceManager
 {
   public:
@@ -34,33 +45,180 @@ class PLDMInstanceManager
     void destroyPLDMInstanceIdDb();
 };
 
+namespace internal
+{
 /**
- * @brief setup PLDM transport for sending and receiving messages
- *
- * @param[in] eid - MCTP endpoint ID
- * @return file descriptor on success and throw
- *         exception (xyz::openbmc_project::Common::Error::NotAllowed) on
- *         failures.
+ * @brief Reads the MCTP endpoint ID out of a file
  */
-int openPLDM(mctp_eid_t eid);
+mctp_eid_t readEID();
+} // namespace internal
 
-/** @brief Opens the MCTP socket for sending and receiving messages.
- *
- * @param[in] eid - MCTP endpoint ID
+/**
+ * @class PLDMTransport
+ * @brief Long lived PLDM transport session to the host over mctp-demux
+ * @details The mctp-demux socket is opened on first use and kept open for
+ *          the life of the service, it is re-opened lazily when a send
+ *          fails. The host endpoint ID is read once and cached. The socket
+ *          is watched on the event loop and received messages are passed
+ *          to the registered response handler. A few PLDM instance IDs are
+ *          reserved for the session and reused in turn, so that a request
+ *          does not take the instance ID database lock.
  */
-int openMctpDemuxTransport(mctp_eid_t eid);
+class PLDMTransport : public Transport
+{
+  public:
+    PLDMTransport() = delete;
+    PLDMTransport(const PLDMTransport&) = delete;
+    PLDMTransport& operator=(const PLDMTransport&) = delete;
+    PLDMTransport(PLDMTransport&&) = delete;
+    PLDMTransport& operator=(PLDMTransport&&) = delete;
+
+    /**
+     * @brief Constructor
+     * @param[in] event - event loop to watch the transport socket on
+     * @param[in] reservedIds - number of instance IDs to reserve
+     */
+    PLDMTransport(sdeventplus::Event& event, size_t reservedIds);
+    ~PLDMTransport() override;
+
+    /**
+     * @brief Register the handler for messages received from the host
+     *
+     * @param[in] handler - callback invoked with each received message
+     */
+    void setResponseHandler(ResponseHandler&& handler) override;
+
+    /**
+     * @brief Host MCTP endpoint ID, read from the EID file on first use
+     *
+     * @return mctp_eid_t - host endpoint ID, throw exception
+     *         (xyz::openbmc_project::Common::Error::NotAllowed) on failures.
+     */
+    mctp_eid_t getEID();
+
+    /**
+     * @brief Send a PLDM message to the host, the transport is opened if
+     *        needed and re-opened once if the send fails
+     *
+     * @param[in] msg - encoded PLDM message
+     * @param[in] msgLen - length of the encoded message
+     * @return PLDM_REQUESTER_SUCCESS on success else requester error code
+     */
+    pldm_requester_rc_t send(const void* msg, size_t msgLen) override;
+
+    /**
+     * @brief Setup PLDM transport for sending and receiving messages, no-op
+     *        if the transport is already open
+     *
+     * @return file descriptor on success and throw
+     *         exception (xyz::openbmc_project::Common::Error::NotAllowed) on
+     *         failures.
+     */
+    int open();
+
+    /** @brief Close the PLDM transport */
+    void close();
+
+    /**
+     * @brief Open the transport and reserve the instance IDs ahead of the
+     *        first request, so that the first request is sent without delay
+     *
+     * @return void, throw exception
+     *         (xyz::openbmc_project::Common::Error::NotAllowed) on failures.
+     */
+    void prepare() override;
 
-/** @brief Close the PLDM file */
-void pldmClose();
+    /**
+     * @brief Close the transport and free the reserved instance IDs not in
+     *        use, IDs in use are freed when their requests complete
+     */
+    void release() override;
+
+    /**
+     * @brief Allocate an instance ID for a request to the host without
+     *        waiting for the instance ID database
+     * @details The reserved instance IDs are allocated on first use, further
+     *          IDs are allocated from the database only while all the
+     *          reserved IDs are in use.
+     *
+     * @return instance ID, std::nullopt if no instance ID is available
+     *         right now, throw exception
+     *         (xyz::openbmc_project::Common::Error::NotAllowed) on failures.
+     */
+    std::optional<pldm_instance_id_t> allocInstanceId() override;
+
+    /**
+     * @brief Free the instance ID once the request is complete, reserved
+     *        IDs are kept for the next requests
+     *
+     * @param[in] instanceId - instance ID of the request
+     */
+    void freeInstanceId(pldm_instance_id_t instanceId) override;
+
+  private:
+    /** @brief Opens the MCTP socket for sending and receiving messages.
+     *
+     * @param[in] eid - MCTP endpoint ID
+     * @return file descriptor on success else negative error code
+     */
+    int openMctpDemuxTransport(mctp_eid_t eid);
+
+    /**
+     * @brief Read a PLDM message from the transport socket
+     *
+     * @param[in] source - IO event source of the socket
+     * @param[in] fd - transport socket
+     * @param[in] revents - events received on the socket
+     */
+    void readMessage(sdeventplus::source::IO& source, int fd,
+                     uint32_t revents);
+
+    /**
+     * @brief Allocate the instance IDs missing from the reservation, as
+     *        many as the instance ID database has available right now
+     */
+    void reserveInstanceIds();
+
+    /** @brief sdevent event handle */
+    sdeventplus::Event& _event;
+
+    /** @brief IO source watching the transport socket while it is open */
+    std::unique_ptr<sdeventplus::source::IO> _ioSource;
+
+    /** @brief handler for messages received from the host */
+    ResponseHandler _responseHandler;
+
+    /** @brief cached host endpoint ID */
+    std::optional<mctp_eid_t> _eid;
+
+    /** @brief mctp-demux transport handle */
+    pldm_transport_mctp_demux* _mctpDemux = nullptr;
+
+    /** @brief PLDM transport handle, valid while the transport is open */
+    pldm_transport* _transport = nullptr;
+
+    /** @brief pollable file descriptor of the open transport */
+    int _fd = -1;
+
+    /** @brief number of instance IDs to reserve for the session */
+    const size_t _reservation;
+
+    /** @brief instance IDs allocated for the life of the session */
+    std::set<pldm_instance_id_t> _reservedIds;
+
+    /** @brief reserved instance IDs not in use, oldest freed first */
+    std::deque<pldm_instance_id_t> _freeIds;
+};
 
 /**
  * @brief Returns the PLDM instance ID to use for PLDM commands
  *
  * @param[in] tid - the terminus ID the instance ID is associated with
  *
- * @return pldm_instance_id_t - The instance ID
+ * @return pldm_instance_id_t - The instance ID, std::nullopt if all the
+ *         instance IDs are in use or the database is busy
  **/
-pldm_instance_id_t getPLDMInstanceID(uint8_t tid);
+std::optional<pldm_instance_id_t> getPLDMInstanceID(uint8_t tid);
 
 /**
  * @brief Free the PLDM instance ID
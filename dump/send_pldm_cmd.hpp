@@ -4,14 +4,17 @@
 
 namespace openpower::dump::pldm
 {
-using ::openpower::dump::utility::DumpType;
+using ::openpower::dump::utility::DumpEntry;
+
+class Transport;
 
 /**
  * @brief Send new dump offload command to PLDM
- * @param[in] dumpId ID of the dump to offload
- * @param[in] dumpType type of the dump
- * @param[in] dumpSize size of the dump to offload
- * @return
+ * @param[in] transport PLDM transport session to the host
+ * @param[in] entry dump to offload, with the PLDM file type resolved from
+ *            the dump entry interface
+ * @return PLDM instance ID of the request, to be freed once the host
+ *         responds
  */
-void sendNewDumpCmd(uint32_t dumpId, DumpType dumpType, uint64_t dumpSize);
+uint8_t sendNewDumpCmd(Transport& transport, const DumpEntry& entry);
 } // namespace openpower::dump::pldm
@@ -0,0 +1,182 @@
+#include "config.h"
+
+#include "dbus_util.hpp"
+
+#include "private_bus.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DbusVariantType;
+using ::openpower::dump::utility::DumpSubtype;
+
+namespace
+{
+using BiosAttributeValue = std::variant<int64_t, std::string>;
+using BiosAttribute =
+    std::tuple<std::string, bool, std::string, std::string, std::string,
+               BiosAttributeValue, BiosAttributeValue,
+               std::vector<std::tuple<std::string, BiosAttributeValue,
+                                      std::string>>>;
+using BaseBIOSTable = std::map<std::string, BiosAttribute>;
+using InterfaceMap =
+    std::map<std::string, std::map<std::string, DbusVariantType>>;
+
+constexpr auto entryPath = "/xyz/openbmc_project/dump/system/entry/1";
+
+BiosAttribute makeAttribute(BiosAttributeValue currentValue)
+{
+    return {"xyz.openbmc_project.BIOSConfig.Manager.AttributeType.Enumeration",
+            false,
+            "",
+            "",
+            "",
+            currentValue,
+            BiosAttributeValue{std::string("Disabled")},
+            {}};
+}
+} // namespace
+
+class DBusUtilTest : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Seal the signal built by the test and rewind it, so that it is
+     *        read as if it was received
+     * @param[in] msg - signal to seal
+     */
+    static void seal(sdbusplus::message::message& msg)
+    {
+        ASSERT_GE(sd_bus_message_seal(msg.get(), 1, 0), 0);
+        ASSERT_GE(sd_bus_message_rewind(msg.get(), true), 0);
+    }
+
+    sdbusplus::message::message biosChanged(
+        const std::map<std::string, std::variant<BaseBIOSTable, bool>>& props)
+    {
+        auto msg = _bus.bus().new_signal(
+            "/xyz/openbmc_project/bios_config/manager", dbusPropIntf,
+            "PropertiesChanged");
+        msg.append("xyz.openbmc_project.BIOSConfig.Manager", props,
+                   std::vector<std::string>{});
+        seal(msg);
+        return msg;
+    }
+
+    sdbusplus::message::message interfacesAdded(const InterfaceMap& intfs)
+    {
+        auto msg = _bus.bus().new_signal("/xyz/openbmc_project/dump",
+                                         dbusObjManagerIntf,
+                                         "InterfacesAdded");
+        msg.append(sdbusplus::message::object_path(entryPath), intfs);
+        seal(msg);
+        return msg;
+    }
+
+    /** @brief signals are built without a bus daemon */
+    test::PrivateBus _bus;
+};
+
+TEST_F(DBusUtilTest, HMCManagedEnabled)
+{
+    BaseBIOSTable table{
+        {"hb_memory_region_size", makeAttribute(int64_t(256))},
+        {"pvm_hmc_managed", makeAttribute(std::string("Enabled"))},
+        {"pvm_system_name", makeAttribute(std::string("Server"))}};
+    auto msg = biosChanged({{"ResetBIOSSettings", false},
+                            {"BaseBIOSTable", table}});
+    EXPECT_EQ(readHMCManagedChanged(msg), true);
+}
+
+TEST_F(DBusUtilTest, HMCManagedDisabled)
+{
+    BaseBIOSTable table{
+        {"pvm_hmc_managed", makeAttribute(std::string("Disabled"))}};
+    auto msg = biosChanged({{"BaseBIOSTable", table}});
+    EXPECT_EQ(readHMCManagedChanged(msg), false);
+}
+
+TEST_F(DBusUtilTest, HMCManagedNotChanged)
+{
+    BaseBIOSTable table{
+        {"pvm_system_name", makeAttribute(std::string("Server"))}};
+    auto msg = biosChanged({{"ResetBIOSSettings", true},
+                            {"BaseBIOSTable", table}});
+    EXPECT_EQ(readHMCManagedChanged(msg), std::nullopt);
+}
+
+TEST_F(DBusUtilTest, HMCManagedUnexpectedType)
+{
+    BaseBIOSTable table{{"pvm_hmc_managed", makeAttribute(int64_t(1))}};
+    auto msg = biosChanged({{"BaseBIOSTable", table}});
+    EXPECT_EQ(readHMCManagedChanged(msg), std::nullopt);
+}
+
+TEST_F(DBusUtilTest, DumpEntryAdded)
+{
+    InterfaceMap intfs{
+        {"com.ibm.Dump.Entry.Hostboot", {}},
+        {"xyz.openbmc_project.Object.Delete", {}},
+        {"xyz.openbmc_project.Time.EpochTime",
+         {{"Elapsed", uint64_t(1000)}}},
+        {progressIntf,
+         {{"Status", std::string(progressComplete)},
+          {"CompletedTime", uint64_t(1700000000)}}},
+        {entryIntf, {{"Size", uint64_t(4096)}, {"Offloaded", true}}},
+        {filePathIntf, {{"Path", std::string("/var/lib/dumps/1")}}}};
+    auto msg = interfacesAdded(intfs);
+
+    sdbusplus::message::object_path path;
+    DumpEntry entry;
+    ASSERT_TRUE(readDumpEntryAdded(msg, path, entry));
+    EXPECT_EQ(path.str, entryPath);
+    EXPECT_EQ(entry.subtype, DumpSubtype::hostboot);
+    EXPECT_EQ(entry.type, DumpType::system);
+    EXPECT_TRUE(entry.completed);
+    EXPECT_EQ(entry.completedTime, 1700000000);
+    EXPECT_EQ(entry.size, 4096);
+    EXPECT_TRUE(entry.offloaded);
+    EXPECT_EQ(entry.filePath, "/var/lib/dumps/1");
+}
+
+TEST_F(DBusUtilTest, DumpEntryInProgress)
+{
+    InterfaceMap intfs{
+        {"xyz.openbmc_project.Dump.Entry.BMC", {}},
+        {progressIntf,
+         {{"Status",
+           std::string(
+               "xyz.openbmc_project.Common.Progress.OperationStatus."
+               "InProgress")}}}};
+    auto msg = interfacesAdded(intfs);
+
+    sdbusplus::message::object_path path;
+    DumpEntry entry;
+    ASSERT_TRUE(readDumpEntryAdded(msg, path, entry));
+    EXPECT_EQ(entry.subtype, DumpSubtype::bmc);
+    EXPECT_FALSE(entry.completed);
+    EXPECT_FALSE(entry.offloaded);
+}
+
+TEST_F(DBusUtilTest, NotDumpEntryAdded)
+{
+    InterfaceMap intfs{{progressIntf, {}}, {entryIntf, {}}};
+    auto msg = interfacesAdded(intfs);
+
+    sdbusplus::message::object_path path;
+    DumpEntry entry;
+    EXPECT_FALSE(readDumpEntryAdded(msg, path, entry));
+}
+} // namespace openpower::dump
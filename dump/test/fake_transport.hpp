@@ -0,0 +1,138 @@
+#pragma once
+
+#include "pldm_transport.hpp"
+
+#include <libpldm/base.h>
+#include <libpldm/oem/ibm/file_io.h>
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace openpower::dump::test
+{
+/**
+ * @brief NewFileAvailable request sent to the fake host
+ */
+struct SentRequest
+{
+    pldm_instance_id_t instanceId = 0;
+    uint16_t fileType = 0;
+    uint32_t fileHandle = 0;
+    uint64_t length = 0;
+};
+
+/**
+ * @class FakeTransport
+ * @brief PLDM transport standing in for the host, the requests sent are
+ *        recorded and the test delivers the host messages
+ */
+class FakeTransport : public pldm::Transport
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param[in] instanceIds - number of instance IDs available
+     */
+    explicit FakeTransport(uint8_t instanceIds = 8)
+    {
+        for (uint8_t id = 0; id < instanceIds; ++id)
+        {
+            freeIds.push_back(id);
+        }
+    }
+
+    void setResponseHandler(ResponseHandler&& handler) override
+    {
+        _handler = std::move(handler);
+    }
+
+    pldm_requester_rc_t send(const void* msg, size_t msgLen) override
+    {
+        auto request = static_cast<const pldm_msg*>(msg);
+        SentRequest sent;
+        sent.instanceId = request->hdr.instance_id;
+        decode_new_file_req(request, msgLen - sizeof(pldm_msg_hdr),
+                            &sent.fileType, &sent.fileHandle, &sent.length);
+        requests.push_back(sent);
+        return PLDM_REQUESTER_SUCCESS;
+    }
+
+    void prepare() override
+    {
+        ++prepared;
+    }
+
+    void release() override
+    {
+        ++released;
+    }
+
+    std::optional<pldm_instance_id_t> allocInstanceId() override
+    {
+        if (freeIds.empty())
+        {
+            return std::nullopt;
+        }
+        auto id = freeIds.front();
+        freeIds.pop_front();
+        return id;
+    }
+
+    void freeInstanceId(pldm_instance_id_t instanceId) override
+    {
+        freeIds.push_back(instanceId);
+        freed.push_back(instanceId);
+    }
+
+    /**
+     * @brief Host responds to the NewFileAvailable request
+     * @param[in] instanceId - instance ID of the request
+     * @param[in] completionCode - completion code of the response
+     */
+    void respond(pldm_instance_id_t instanceId, uint8_t completionCode)
+    {
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_NEW_FILE_RESP_BYTES);
+        auto response = reinterpret_cast<pldm_msg*>(msg.data());
+        encode_new_file_resp(instanceId, completionCode, response);
+        _handler(response, msg.size());
+    }
+
+    /**
+     * @brief Host acknowledges the transfer of the file
+     * @param[in] fileType - PLDM file type of the dump
+     * @param[in] fileHandle - dump id
+     * @param[in] fileStatus - status of the transfer
+     */
+    void fileAck(uint16_t fileType, uint32_t fileHandle,
+                 uint8_t fileStatus = PLDM_SUCCESS)
+    {
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_FILE_ACK_REQ_BYTES);
+        auto request = reinterpret_cast<pldm_msg*>(msg.data());
+        encode_file_ack_req(0, fileType, fileHandle, fileStatus, request);
+        _handler(request, msg.size());
+    }
+
+    /** @brief requests sent in order */
+    std::vector<SentRequest> requests;
+
+    /** @brief instance IDs available to allocate */
+    std::deque<pldm_instance_id_t> freeIds;
+
+    /** @brief instance IDs freed in order */
+    std::vector<pldm_instance_id_t> freed;
+
+    /** @brief number of times the transport was prepared */
+    size_t prepared = 0;
+
+    /** @brief number of times the transport was released */
+    size_t released = 0;
+
+  private:
+    /** @brief handler of the host messages */
+    ResponseHandler _handler;
+};
+} // namespace openpower::dump::test
@@ -0,0 +1,385 @@
+#include "config.h"
+
+#include "host_offloader_queue.hpp"
+
+#include "fake_transport.hpp"
+#include "private_bus.hpp"
+
+#include <libpldm/base.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::toDumpType;
+using ::openpower::dump::utility::toPldmFileType;
+
+namespace
+{
+constexpr auto responseTimeout = std::chrono::milliseconds(10);
+
+std::filesystem::path makeTempDir()
+{
+    char dir[] = "/tmp/host_offloader_queue_test.XXXXXX";
+    if (mkdtemp(dir) == nullptr)
+    {
+        throw std::runtime_error("mkdtemp failed");
+    }
+    return dir;
+}
+
+std::string entryPath(uint32_t id)
+{
+    return "/xyz/openbmc_project/dump/bmc/entry/" + std::to_string(id);
+}
+
+DumpEntry makeEntry(uint32_t id, uint64_t completedTime = 0)
+{
+    DumpEntry entry;
+    entry.id = id;
+    entry.subtype = DumpSubtype::bmc;
+    entry.type = toDumpType(entry.subtype);
+    entry.fileType = toPldmFileType(entry.subtype);
+    entry.size = 4096;
+    entry.completed = true;
+    entry.completedTime = completedTime;
+    entry.discoveredTime = std::chrono::steady_clock::now();
+    return entry;
+}
+} // namespace
+
+class HostOffloaderQueueTest : public ::testing::Test
+{
+  protected:
+    ~HostOffloaderQueueTest() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    /** @brief Host is running and the system is not HMC managed */
+    void startOffload()
+    {
+        _queue.hmcStateChange(false);
+        _queue.hostStateChange(true);
+        run();
+    }
+
+    /** @brief Dispatch the events ready to run */
+    void run()
+    {
+        while (_event.run(std::chrono::microseconds(0)) > 0)
+        {}
+    }
+
+    /**
+     * @brief Dispatch the events for the duration
+     * @param[in] duration - time to run the event loop
+     */
+    void runFor(std::chrono::milliseconds duration)
+    {
+        auto end = std::chrono::steady_clock::now() + duration;
+        for (auto now = std::chrono::steady_clock::now(); now < end;
+             now = std::chrono::steady_clock::now())
+        {
+            _event.run(
+                std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                      now));
+        }
+    }
+
+    void enqueue(const DumpEntry& entry)
+    {
+        _queue.enqueue(object_path(entryPath(entry.id)), entry);
+    }
+
+    JournalState journalState(uint32_t id) const
+    {
+        return _journal.dumps().at(entryPath(id)).state;
+    }
+
+    std::filesystem::path _dir = makeTempDir();
+    OffloadJournal _journal{_dir / "journal"};
+    sdeventplus::Event _event = sdeventplus::Event::get_new();
+    test::PrivateBus _bus;
+    test::FakeTransport _transport;
+    OffloadMetrics _metrics;
+    HostOffloaderQueue _queue{_bus.bus(), _event,   _transport,
+                              _metrics,   _journal, responseTimeout};
+};
+
+TEST_F(HostOffloaderQueueTest, HeldUntilHostRunning)
+{
+    enqueue(makeEntry(1));
+    run();
+    EXPECT_TRUE(_transport.requests.empty());
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+
+    startOffload();
+    ASSERT_EQ(_transport.requests.size(), 1);
+    EXPECT_EQ(_transport.requests[0].fileHandle, 1);
+    EXPECT_EQ(_transport.requests[0].fileType,
+              toPldmFileType(DumpSubtype::bmc));
+    EXPECT_EQ(_transport.requests[0].length, 4096);
+    EXPECT_EQ(_queue.inFlight(), 1);
+    EXPECT_EQ(journalState(1), JournalState::sent);
+    EXPECT_EQ(_metrics.enqueueToSend.count(), 1);
+}
+
+TEST_F(HostOffloaderQueueTest, OffloadWindowLimitsRequests)
+{
+    startOffload();
+    for (uint32_t id = 1; id <= offloadWindowSize + 1; ++id)
+    {
+        enqueue(makeEntry(id));
+    }
+    run();
+    EXPECT_EQ(_transport.requests.size(), offloadWindowSize);
+    EXPECT_EQ(_queue.inFlight(), offloadWindowSize);
+}
+
+TEST_F(HostOffloaderQueueTest, OffloadedInCompletionOrder)
+{
+    enqueue(makeEntry(1, 300));
+    enqueue(makeEntry(2, 100));
+    enqueue(makeEntry(3, 200));
+    startOffload();
+
+    // complete the offloads as they are sent until the queue is empty
+    std::vector<uint32_t> order;
+    for (size_t i = 0; i < _transport.requests.size(); ++i)
+    {
+        auto sent = _transport.requests[i];
+        order.push_back(sent.fileHandle);
+        _transport.fileAck(sent.fileType, sent.fileHandle);
+        run();
+    }
+    EXPECT_EQ(order, (std::vector<uint32_t>{2, 3, 1}));
+}
+
+TEST_F(HostOffloaderQueueTest, FileAckCompletesOffload)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    ASSERT_EQ(_transport.requests.size(), 1);
+    auto sent = _transport.requests[0];
+
+    _transport.respond(sent.instanceId, PLDM_SUCCESS);
+    EXPECT_EQ(journalState(1), JournalState::acknowledged);
+    EXPECT_EQ(_transport.freed, std::vector<pldm_instance_id_t>{
+                                    sent.instanceId});
+    EXPECT_EQ(_queue.inFlight(), 1);
+    EXPECT_EQ(_metrics.dumpsOffloaded, 0);
+
+    _transport.fileAck(sent.fileType, sent.fileHandle);
+    EXPECT_FALSE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_FALSE(_journal.dumps().contains(entryPath(1)));
+    EXPECT_EQ(_metrics.dumpsOffloaded, 1);
+    EXPECT_EQ(_metrics.bytesOffloaded, 4096);
+    EXPECT_EQ(_metrics.sendToCompletion.count(), 1);
+}
+
+TEST_F(HostOffloaderQueueTest, FailedFileAckKeepsOffload)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    auto sent = _transport.requests.at(0);
+    _transport.respond(sent.instanceId, PLDM_SUCCESS);
+
+    _transport.fileAck(sent.fileType, sent.fileHandle, PLDM_ERROR);
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(_queue.inFlight(), 1);
+    EXPECT_EQ(_metrics.dumpsOffloaded, 0);
+}
+
+TEST_F(HostOffloaderQueueTest, RemovalAfterAcceptCompletesOffload)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    _transport.respond(_transport.requests.at(0).instanceId, PLDM_SUCCESS);
+
+    _queue.remove(object_path(entryPath(1)));
+    EXPECT_FALSE(_queue.isQueued(entryPath(1)));
+    run();
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_FALSE(_journal.dumps().contains(entryPath(1)));
+    EXPECT_EQ(_metrics.dumpsOffloaded, 1);
+}
+
+TEST_F(HostOffloaderQueueTest, RemovalBeforeAcceptIsNotOffloaded)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    auto sent = _transport.requests.at(0);
+
+    _queue.remove(object_path(entryPath(1)));
+    run();
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_EQ(_transport.freed, std::vector<pldm_instance_id_t>{
+                                    sent.instanceId});
+    EXPECT_FALSE(_journal.dumps().contains(entryPath(1)));
+    EXPECT_EQ(_metrics.dumpsOffloaded, 0);
+
+    // late response to the request of the removed dump is ignored
+    _transport.respond(sent.instanceId, PLDM_SUCCESS);
+    EXPECT_EQ(_queue.inFlight(), 0);
+}
+
+TEST_F(HostOffloaderQueueTest, TransientRejectionKeepsDumpQueued)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+
+    _transport.respond(_transport.requests.at(0).instanceId,
+                       PLDM_ERROR_NOT_READY);
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_EQ(journalState(1), JournalState::queued);
+
+    // dump is retried after the backoff, not right away
+    run();
+    EXPECT_EQ(_transport.requests.size(), 1);
+}
+
+TEST_F(HostOffloaderQueueTest, PermanentRejectionDropsDump)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+
+    _transport.respond(_transport.requests.at(0).instanceId,
+                       PLDM_ERROR_INVALID_DATA);
+    EXPECT_FALSE(_queue.isQueued(entryPath(1)));
+    EXPECT_FALSE(_journal.dumps().contains(entryPath(1)));
+    EXPECT_EQ(_metrics.dumpsOffloaded, 0);
+    EXPECT_EQ(_metrics.sendToCompletion.count(), 0);
+}
+
+TEST_F(HostOffloaderQueueTest, ResponseTimeoutRequeuesDump)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    auto sent = _transport.requests.at(0);
+
+    runFor(responseTimeout * 5);
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_EQ(journalState(1), JournalState::queued);
+    EXPECT_EQ(_transport.freed, std::vector<pldm_instance_id_t>{
+                                    sent.instanceId});
+
+    // response after the timeout is not taken for the requeued dump
+    _transport.respond(sent.instanceId, PLDM_SUCCESS);
+    EXPECT_EQ(_queue.inFlight(), 0);
+}
+
+TEST_F(HostOffloaderQueueTest, RetriedWhenNoInstanceIdAvailable)
+{
+    auto freeIds = std::move(_transport.freeIds);
+    _transport.freeIds.clear();
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    EXPECT_TRUE(_transport.requests.empty());
+    EXPECT_EQ(_metrics.sendFailures, 0);
+
+    _transport.freeIds = std::move(freeIds);
+    runFor(std::chrono::milliseconds(300));
+    EXPECT_EQ(_transport.requests.size(), 1);
+    EXPECT_EQ(_queue.inFlight(), 1);
+}
+
+TEST_F(HostOffloaderQueueTest, HMCManagedPausesOffload)
+{
+    startOffload();
+    enqueue(makeEntry(1));
+    run();
+    auto sent = _transport.requests.at(0);
+
+    _queue.hmcStateChange(true);
+    EXPECT_EQ(_transport.released, 1);
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(journalState(1), JournalState::queued);
+    EXPECT_EQ(_transport.freed, std::vector<pldm_instance_id_t>{
+                                    sent.instanceId});
+
+    // queued dumps are announced again once offload resumes
+    _queue.hmcStateChange(false);
+    run();
+    EXPECT_EQ(_transport.requests.size(), 2);
+}
+
+TEST_F(HostOffloaderQueueTest, RestoredOffloadHeldUntilStateRead)
+{
+    auto entry = makeEntry(1);
+    _journal.queued(entryPath(1), entry);
+    _journal.acknowledged(entryPath(1));
+
+    // the reads stay pending on the private bus
+    _queue.readInitialState();
+    _queue.restore(object_path(entryPath(1)), entry,
+                   JournalState::acknowledged);
+    _queue.hostStateChange(true);
+    EXPECT_EQ(_queue.inFlight(), 0);
+
+    _queue.hmcStateChange(false);
+    run();
+    EXPECT_EQ(_queue.inFlight(), 1);
+    EXPECT_TRUE(_transport.requests.empty());
+    EXPECT_EQ(journalState(1), JournalState::acknowledged);
+
+    _transport.fileAck(entry.fileType, entry.id);
+    EXPECT_FALSE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(_metrics.dumpsOffloaded, 1);
+}
+
+TEST_F(HostOffloaderQueueTest, RestoredOffloadRequeuedWhenHostNotRunning)
+{
+    auto entry = makeEntry(1);
+    _journal.queued(entryPath(1), entry);
+    _journal.sent(entryPath(1));
+
+    _queue.restore(object_path(entryPath(1)), entry, JournalState::sent);
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_EQ(journalState(1), JournalState::queued);
+
+    startOffload();
+    ASSERT_EQ(_transport.requests.size(), 1);
+    EXPECT_EQ(_transport.requests[0].fileHandle, 1);
+}
+
+TEST_F(HostOffloaderQueueTest, RestoredSentOffloadRequeuedOnTimeout)
+{
+    auto entry = makeEntry(1);
+    _journal.queued(entryPath(1), entry);
+    _journal.sent(entryPath(1));
+
+    startOffload();
+    _queue.restore(object_path(entryPath(1)), entry, JournalState::sent);
+    run();
+    EXPECT_EQ(_queue.inFlight(), 1);
+    EXPECT_TRUE(_transport.requests.empty());
+
+    // host did not respond to the request sent before the restart
+    runFor(responseTimeout * 5);
+    EXPECT_EQ(_queue.inFlight(), 0);
+    EXPECT_TRUE(_queue.isQueued(entryPath(1)));
+    EXPECT_EQ(journalState(1), JournalState::queued);
+}
+} // namespace openpower::dump
@@ -0,0 +1,231 @@
+#include "offload_journal.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpSubtype;
+
+class OffloadJournalTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/offload_journal_test.XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        _dir = dir;
+        _file = _dir / "journal";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    static DumpEntry makeEntry(uint32_t id, DumpSubtype subtype,
+                               uint64_t completedTime)
+    {
+        DumpEntry entry;
+        entry.id = id;
+        entry.subtype = subtype;
+        entry.size = id * 1024;
+        entry.completedTime = completedTime;
+        return entry;
+    }
+
+    size_t lineCount() const
+    {
+        std::ifstream stream(_file);
+        std::string line;
+        size_t count = 0;
+        while (std::getline(stream, line))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    std::filesystem::path _dir;
+    std::filesystem::path _file;
+};
+
+TEST_F(OffloadJournalTest, ReplaysStates)
+{
+    {
+        OffloadJournal journal(_file);
+        journal.queued("/dump/1", makeEntry(1, DumpSubtype::bmc, 100));
+        journal.queued("/dump/2", makeEntry(2, DumpSubtype::sbe, 200));
+        journal.queued("/dump/3", makeEntry(3, DumpSubtype::hostboot, 300));
+        journal.queued("/dump/4", makeEntry(4, DumpSubtype::hardware, 400));
+        journal.sent("/dump/2");
+        journal.sent("/dump/3");
+        journal.acknowledged("/dump/3");
+        journal.sent("/dump/4");
+        journal.requeued("/dump/4");
+        journal.removed("/dump/1");
+    }
+
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    ASSERT_EQ(dumps.size(), 3);
+    EXPECT_FALSE(dumps.contains("/dump/1"));
+
+    const auto& sent = dumps.at("/dump/2");
+    EXPECT_EQ(sent.state, JournalState::sent);
+    EXPECT_EQ(sent.entry.id, 2);
+    EXPECT_EQ(sent.entry.subtype, DumpSubtype::sbe);
+    EXPECT_EQ(sent.entry.size, 2048);
+    EXPECT_EQ(sent.entry.completedTime, 200);
+    EXPECT_TRUE(sent.entry.completed);
+
+    EXPECT_EQ(dumps.at("/dump/3").state, JournalState::acknowledged);
+    EXPECT_EQ(dumps.at("/dump/4").state, JournalState::queued);
+    EXPECT_EQ(dumps.at("/dump/4").entry.subtype, DumpSubtype::hardware);
+}
+
+TEST_F(OffloadJournalTest, ReplaysFilePath)
+{
+    {
+        OffloadJournal journal(_file);
+        auto entry = makeEntry(1, DumpSubtype::bmc, 100);
+        entry.filePath = "/var/lib/dumps/1/BMCDUMP 1";
+        journal.queued("/dump/1", entry);
+        journal.queued("/dump/2", makeEntry(2, DumpSubtype::sbe, 200));
+    }
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    ASSERT_EQ(dumps.size(), 2);
+    EXPECT_EQ(dumps.at("/dump/1").entry.filePath,
+              "/var/lib/dumps/1/BMCDUMP 1");
+    EXPECT_EQ(dumps.at("/dump/1").entry.completedTime, 100);
+    EXPECT_TRUE(dumps.at("/dump/2").entry.filePath.empty());
+}
+
+TEST_F(OffloadJournalTest, IgnoresPartialLastLine)
+{
+    {
+        std::ofstream stream(_file);
+        stream << "Q /dump/1 1 0 1024 100\n"
+               << "Q /dump/2 2 1 2048 200\n"
+               << "S /dump/1";
+    }
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    ASSERT_EQ(dumps.size(), 2);
+    EXPECT_EQ(dumps.at("/dump/1").state, JournalState::queued);
+}
+
+TEST_F(OffloadJournalTest, IgnoresMalformedLines)
+{
+    {
+        std::ofstream stream(_file);
+        stream << "Q /dump/1 1 9 1024 100\n"
+               << "Q /dump/2 two 1 2048 200\n"
+               << "S /dump/3\n"
+               << "X /dump/1\n"
+               << "Q /dump/4 4 2 4096 400\n";
+    }
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    ASSERT_EQ(dumps.size(), 1);
+    EXPECT_EQ(dumps.at("/dump/4").entry.subtype, DumpSubtype::hostboot);
+}
+
+TEST_F(OffloadJournalTest, LoadsLinesWithoutCompletionTime)
+{
+    {
+        std::ofstream stream(_file);
+        stream << "Q /dump/1 1 0 1024\n";
+    }
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    ASSERT_EQ(dumps.size(), 1);
+    EXPECT_EQ(dumps.at("/dump/1").entry.size, 1024);
+    EXPECT_EQ(dumps.at("/dump/1").entry.completedTime, 0);
+}
+
+TEST_F(OffloadJournalTest, CompactsOnLoad)
+{
+    {
+        OffloadJournal journal(_file);
+        journal.queued("/dump/1", makeEntry(1, DumpSubtype::bmc, 100));
+        journal.queued("/dump/2", makeEntry(2, DumpSubtype::bmc, 200));
+        journal.sent("/dump/2");
+        journal.removed("/dump/1");
+    }
+    EXPECT_EQ(lineCount(), 4);
+
+    OffloadJournal journal(_file);
+    EXPECT_EQ(lineCount(), 2);
+    EXPECT_FALSE(std::filesystem::exists(_dir / "journal.tmp"));
+    EXPECT_EQ(journal.dumps().at("/dump/2").state, JournalState::sent);
+}
+
+TEST_F(OffloadJournalTest, CompactsWhenLinesOutgrowDumps)
+{
+    OffloadJournal journal(_file);
+    for (uint32_t id = 0; id < 1000; ++id)
+    {
+        auto path = "/dump/" + std::to_string(id);
+        journal.queued(path, makeEntry(id, DumpSubtype::bmc, id));
+        journal.removed(path);
+    }
+    EXPECT_TRUE(journal.dumps().empty());
+    EXPECT_LT(lineCount(), 1000);
+
+    OffloadJournal replayed(_file);
+    EXPECT_TRUE(replayed.dumps().empty());
+}
+
+TEST_F(OffloadJournalTest, KeepsAppendingWhenCompactionFails)
+{
+    {
+        OffloadJournal journal(_file);
+
+        // the rewritten journal can not be written
+        std::filesystem::create_directory(_dir / "journal.tmp");
+        for (uint32_t id = 0; id < 1000; ++id)
+        {
+            auto path = "/dump/" + std::to_string(id);
+            journal.queued(path, makeEntry(id, DumpSubtype::bmc, id));
+            journal.sent(path);
+            if (id % 2 == 0)
+            {
+                journal.removed(path);
+            }
+        }
+        journal.removed(std::vector<std::string>{"/dump/1", "/dump/3"});
+        EXPECT_GT(lineCount(), 2500);
+    }
+    std::filesystem::remove(_dir / "journal.tmp");
+
+    OffloadJournal journal(_file);
+    const auto& dumps = journal.dumps();
+    EXPECT_EQ(dumps.size(), 498);
+    EXPECT_FALSE(dumps.contains("/dump/0"));
+    EXPECT_FALSE(dumps.contains("/dump/1"));
+    EXPECT_EQ(dumps.at("/dump/999").state, JournalState::sent);
+    EXPECT_EQ(lineCount(), 2 * 498);
+}
+
+TEST_F(OffloadJournalTest, RemovesBatch)
+{
+    {
+        OffloadJournal journal(_file);
+        journal.queued("/dump/1", makeEntry(1, DumpSubtype::bmc, 100));
+        journal.queued("/dump/2", makeEntry(2, DumpSubtype::bmc, 200));
+        journal.queued("/dump/3", makeEntry(3, DumpSubtype::bmc, 300));
+        journal.removed(
+            std::vector<std::string>{"/dump/1", "/dump/3", "/dump/9"});
+        EXPECT_EQ(journal.dumps().size(), 1);
+    }
+    OffloadJournal journal(_file);
+    ASSERT_EQ(journal.dumps().size(), 1);
+    EXPECT_TRUE(journal.dumps().contains("/dump/2"));
+}
+} // namespace openpower::dump
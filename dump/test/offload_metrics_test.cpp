@@ -0,0 +1,54 @@
+#include "offload_metrics.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+TEST(LatencyStatsTest, Empty)
+{
+    LatencyStats stats;
+    EXPECT_EQ(stats.count(), 0);
+    EXPECT_EQ(stats.mean(), LatencyStats::Duration::zero());
+    for (auto count : stats.histogram())
+    {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+TEST(LatencyStatsTest, MinMaxMean)
+{
+    LatencyStats stats;
+    stats.add(std::chrono::milliseconds(300));
+    stats.add(std::chrono::milliseconds(100));
+    stats.add(std::chrono::milliseconds(200));
+    EXPECT_EQ(stats.count(), 3);
+    EXPECT_EQ(stats.min(), std::chrono::milliseconds(100));
+    EXPECT_EQ(stats.max(), std::chrono::milliseconds(300));
+    EXPECT_EQ(stats.mean(), std::chrono::milliseconds(200));
+}
+
+TEST(LatencyStatsTest, BucketBoundsAreInclusive)
+{
+    LatencyStats stats;
+    stats.add(std::chrono::milliseconds(0));
+    stats.add(std::chrono::milliseconds(10));
+    stats.add(std::chrono::milliseconds(11));
+    stats.add(std::chrono::seconds(1));
+    const auto& histogram = stats.histogram();
+    EXPECT_EQ(histogram[0], 2);
+    EXPECT_EQ(histogram[1], 1);
+    EXPECT_EQ(histogram[3], 1);
+}
+
+TEST(LatencyStatsTest, OverflowBucket)
+{
+    LatencyStats stats;
+    stats.add(std::chrono::hours(1));
+    stats.add(std::chrono::hours(1) + std::chrono::milliseconds(1));
+    const auto& histogram = stats.histogram();
+    EXPECT_EQ(histogram[latencyBuckets.size() - 1], 1);
+    EXPECT_EQ(histogram[latencyBuckets.size()], 1);
+}
+} // namespace openpower::dump
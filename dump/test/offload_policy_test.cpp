@@ -0,0 +1,54 @@
+#include "offload_policy.hpp"
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+using ::openpower::dump::utility::DumpSubtype;
+
+namespace
+{
+DumpEntry makeEntry(DumpSubtype subtype, uint64_t size)
+{
+    DumpEntry entry;
+    entry.subtype = subtype;
+    entry.size = size;
+    return entry;
+}
+} // namespace
+
+TEST(OffloadPolicyTest, ParsesPolicyName)
+{
+    EXPECT_EQ(toOffloadPolicy("fifo"), OffloadPolicy::fifo);
+    EXPECT_EQ(toOffloadPolicy("smallest-first"), OffloadPolicy::smallestFirst);
+    EXPECT_EQ(toOffloadPolicy("type-priority"), OffloadPolicy::typePriority);
+    EXPECT_EQ(toOffloadPolicy("largest-first"), OffloadPolicy::fifo);
+}
+
+TEST(OffloadPolicyTest, FifoRanksDumpsEqually)
+{
+    EXPECT_EQ(offloadRank(OffloadPolicy::fifo,
+                          makeEntry(DumpSubtype::hardware, 1024)),
+              offloadRank(OffloadPolicy::fifo,
+                          makeEntry(DumpSubtype::sbe, 4096)));
+}
+
+TEST(OffloadPolicyTest, SmallestFirstRanksBySize)
+{
+    EXPECT_LT(offloadRank(OffloadPolicy::smallestFirst,
+                          makeEntry(DumpSubtype::hardware, 1024)),
+              offloadRank(OffloadPolicy::smallestFirst,
+                          makeEntry(DumpSubtype::sbe, 4096)));
+}
+
+TEST(OffloadPolicyTest, TypePriorityRanksBySubtype)
+{
+    auto rank = [](DumpSubtype subtype) {
+        return offloadRank(OffloadPolicy::typePriority,
+                           makeEntry(subtype, 1024));
+    };
+    EXPECT_EQ(rank(DumpSubtype::sbe), rank(DumpSubtype::hostboot));
+    EXPECT_LT(rank(DumpSubtype::hostboot), rank(DumpSubtype::bmc));
+    EXPECT_LT(rank(DumpSubtype::bmc), rank(DumpSubtype::hardware));
+}
+} // namespace openpower::dump
@@ -0,0 +1,98 @@
+#include "host_offloader_queue.hpp"
+
+#include "fake_transport.hpp"
+#include "private_bus.hpp"
+
+#include <fmt/format.h>
+#include <libpldm/base.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Drive synthetic dumps through the offload queue with a fake host
+ *        accepting and completing every offload, and report the latencies
+ *        of the queue
+ * @details Usage: offload_queue_benchmark [dumps], 1000 dumps by default.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump;
+    using ::openpower::dump::utility::toDumpType;
+    using ::openpower::dump::utility::toPldmFileType;
+
+    uint32_t dumps = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+
+    char dir[] = "/tmp/offload_queue_benchmark.XXXXXX";
+    if (mkdtemp(dir) == nullptr)
+    {
+        return EXIT_FAILURE;
+    }
+    int rc = EXIT_SUCCESS;
+    {
+        OffloadJournal journal(std::filesystem::path(dir) / "journal");
+        auto event = sdeventplus::Event::get_new();
+        test::PrivateBus bus;
+        test::FakeTransport transport;
+        OffloadMetrics metrics;
+        HostOffloaderQueue queue(bus.bus(), event, transport, metrics,
+                                 journal);
+        queue.hmcStateChange(false);
+        queue.hostStateChange(true);
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t id = 1; id <= dumps; ++id)
+        {
+            DumpEntry entry;
+            entry.id = id;
+            entry.type = toDumpType(entry.subtype);
+            entry.fileType = toPldmFileType(entry.subtype);
+            entry.size = 1024 * 1024;
+            entry.completed = true;
+            entry.completedTime = id;
+            entry.discoveredTime = std::chrono::steady_clock::now();
+            queue.enqueue(sdbusplus::message::object_path(
+                              "/xyz/openbmc_project/dump/bmc/entry/" +
+                              std::to_string(id)),
+                          entry);
+        }
+
+        // host accepts and completes each offload as it is sent
+        size_t answered = 0;
+        while (event.run(std::chrono::microseconds(0)) > 0 ||
+               answered < transport.requests.size())
+        {
+            for (; answered < transport.requests.size(); ++answered)
+            {
+                auto sent = transport.requests[answered];
+                transport.respond(sent.instanceId, PLDM_SUCCESS);
+                transport.fileAck(sent.fileType, sent.fileHandle);
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        auto us = [](LatencyStats::Duration duration) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       duration)
+                .count();
+        };
+        fmt::print("dumps ({}) offloaded ({}) elapsed ({} us)\n", dumps,
+                   metrics.dumpsOffloaded, us(elapsed));
+        fmt::print("enqueue to send mean ({} us) max ({} us)\n",
+                   us(metrics.enqueueToSend.mean()),
+                   us(metrics.enqueueToSend.max()));
+        fmt::print("send to completion mean ({} us) max ({} us)\n",
+                   us(metrics.sendToCompletion.mean()),
+                   us(metrics.sendToCompletion.max()));
+        if (metrics.dumpsOffloaded != dumps)
+        {
+            rc = EXIT_FAILURE;
+        }
+    }
+    std::filesystem::remove_all(dir);
+    return rc;
+}
@@ -0,0 +1,66 @@
+#include "offload_trace.hpp"
+
+#include <fmt/format.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace openpower::dump
+{
+namespace
+{
+size_t countOf(const std::string& json, const std::string& text)
+{
+    size_t count = 0;
+    for (auto pos = json.find(text); pos != std::string::npos;
+         pos = json.find(text, pos + text.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+constexpr auto fileType = static_cast<pldm_fileio_file_type>(0x10);
+} // namespace
+
+TEST(OffloadTraceTest, EmptyTrace)
+{
+    OffloadTrace trace;
+    EXPECT_EQ(trace.toJson(), "[]");
+}
+
+TEST(OffloadTraceTest, RecordsInOrder)
+{
+    OffloadTrace trace;
+    trace.record(TraceEvent::enqueued, 1, fileType);
+    trace.record(TraceEvent::sent, 1, fileType, 7);
+    auto json = trace.toJson();
+    EXPECT_EQ(countOf(json, "\"timestamp\""), 2);
+    EXPECT_LT(json.find("\"event\":\"enqueued\""),
+              json.find("\"event\":\"sent\""));
+    EXPECT_NE(json.find("\"fileType\":16,\"event\":\"sent\",\"detail\":7"),
+              std::string::npos);
+}
+
+TEST(OffloadTraceTest, WrapOverwritesOldestRecords)
+{
+    OffloadTrace trace;
+    for (uint32_t id = 0; id < traceRecords + 2; ++id)
+    {
+        trace.record(TraceEvent::discovered, id, fileType);
+    }
+    auto json = trace.toJson();
+    EXPECT_EQ(countOf(json, "\"timestamp\""), traceRecords);
+    EXPECT_EQ(json.find("\"id\":0,"), std::string::npos);
+    EXPECT_EQ(json.find("\"id\":1,"), std::string::npos);
+
+    // oldest record kept comes first, newest last
+    auto first = json.find("\"id\":2,");
+    auto last = json.find(fmt::format("\"id\":{},", traceRecords + 1));
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(last, std::string::npos);
+    EXPECT_LT(first, last);
+    EXPECT_EQ(json.find("\"id\":"), first);
+}
+} // namespace openpower::dump
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <systemd/sd-bus.h>
+#include <unistd.h>
+
+#include <sdbusplus/bus.hpp>
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace openpower::dump::test
+{
+/**
+ * @class PrivateBus
+ * @brief D-Bus connection to a socket pair instead of the system bus
+ * @details Messages are built and sealed without a bus daemon, method calls
+ *          sent on the connection stay pending as no peer answers them.
+ */
+class PrivateBus
+{
+  public:
+    PrivateBus() : _bus(connect(), std::false_type())
+    {}
+
+    PrivateBus(const PrivateBus&) = delete;
+    PrivateBus& operator=(const PrivateBus&) = delete;
+
+    ~PrivateBus()
+    {
+        // without the peer the connection is not left waiting for the
+        // authentication when it is flushed on close
+        ::close(_peer);
+    }
+
+    sdbusplus::bus::bus& bus()
+    {
+        return _bus;
+    }
+
+  private:
+    /**
+     * @brief Open the connection on one end of a socket pair
+     * @return connection, the other end is kept as the peer
+     */
+    sd_bus* connect()
+    {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                         0, fds) != 0)
+        {
+            throw std::runtime_error("socketpair failed");
+        }
+        _peer = fds[1];
+        sd_bus* bus = nullptr;
+        if (sd_bus_new(&bus) < 0 || sd_bus_set_fd(bus, fds[0], fds[0]) < 0 ||
+            sd_bus_start(bus) < 0)
+        {
+            sd_bus_unref(bus);
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error("private bus failed to start");
+        }
+        return bus;
+    }
+
+    /** @brief peer end of the socket pair */
+    int _peer = -1;
+
+    /** @brief connection, closed after the peer */
+    sdbusplus::bus::bus _bus;
+};
+} // namespace openpower::dump::test
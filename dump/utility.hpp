@@ -1,9 +1,18 @@
 #pragma once
 
+#include <libpldm/oem/ibm/file_io.h>
+
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/utility/dedup_variant.hpp>
 #include <xyz/openbmc_project/State/Boot/Progress/server.hpp>
 
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
 using ProgressStages = sdbusplus::xyz::openbmc_project::State::Boot::server::
     Progress::ProgressStages;
 
@@ -41,4 +50,114 @@ enum class DumpType
     system
 };
 
+/**
+ * @brief Dump identified by the concrete dump entry interface
+ */
+enum class DumpSubtype
+{
+    bmc,
+    sbe,
+    hostboot,
+    hardware
+};
+
+/**
+ * @brief Dump entry interfaces and the dump subtype they identify
+ */
+constexpr std::array<std::pair<std::string_view, DumpSubtype>, 4>
+    entryIntfTable{{
+        {"xyz.openbmc_project.Dump.Entry.BMC", DumpSubtype::bmc},
+        {"com.ibm.Dump.Entry.SBE", DumpSubtype::sbe},
+        {"com.ibm.Dump.Entry.Hostboot", DumpSubtype::hostboot},
+        {"com.ibm.Dump.Entry.Hardware", DumpSubtype::hardware},
+    }};
+
+/**
+ * @brief Dump subtype identified by the entry interface
+ * @param[in] intf interface name
+ * @return dump subtype, empty if the interface is not a dump entry interface
+ */
+constexpr std::optional<DumpSubtype> toDumpSubtype(std::string_view intf)
+{
+    for (const auto& [name, subtype] : entryIntfTable)
+    {
+        if (name == intf)
+        {
+            return subtype;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Type of the dump the subtype belongs to
+ * @param[in] subtype dump subtype
+ * @return dump type
+ */
+constexpr DumpType toDumpType(DumpSubtype subtype)
+{
+    return subtype == DumpSubtype::bmc ? DumpType::bmc : DumpType::system;
+}
+
+/**
+ * @brief PLDM file type used to offload the dump subtype
+ * @param[in] subtype dump subtype
+ * @return PLDM file type
+ */
+constexpr pldm_fileio_file_type toPldmFileType(DumpSubtype subtype)
+{
+    switch (subtype)
+    {
+        case DumpSubtype::sbe:
+            return static_cast<pldm_fileio_file_type>(
+                0x10); // PLDM_FILE_TYPE_SBE_DUMP
+        case DumpSubtype::hostboot:
+            return static_cast<pldm_fileio_file_type>(
+                0x11); // PLDM_FILE_TYPE_HOSTBOOT_DUMP
+        case DumpSubtype::hardware:
+            return static_cast<pldm_fileio_file_type>(
+                0x12); // PLDM_FILE_TYPE_HARDWARE_DUMP
+        case DumpSubtype::bmc:
+        default:
+            return static_cast<pldm_fileio_file_type>(
+                0xF); // PLDM_FILE_TYPE_BMC_DUMP
+    }
+}
+
+/**
+ * @brief Dump entry metadata captured from the dump manager signals
+ */
+struct DumpEntry
+{
+    /** @brief type of the dump */
+    DumpType type = DumpType::bmc;
+
+    /** @brief dump id parsed from the entry object path */
+    uint32_t id = 0;
+
+    /** @brief size of the dump in bytes */
+    uint64_t size = 0;
+
+    /** @brief true once the dump generation is completed */
+    bool completed = false;
+
+    /** @brief true once the dump manager marked the dump offloaded */
+    bool offloaded = false;
+
+    /** @brief dump identified by the entry interface of the object */
+    DumpSubtype subtype = DumpSubtype::bmc;
+
+    /** @brief PLDM file type resolved from the entry interface */
+    pldm_fileio_file_type fileType = toPldmFileType(DumpSubtype::bmc);
+
+    /** @brief completion time of the dump in epoch, 0 if not known */
+    uint64_t completedTime = 0;
+
+    /** @brief time the dump entry was discovered */
+    std::chrono::steady_clock::time_point discoveredTime;
+
+    /** @brief path of the dump file, empty if not stored on the BMC */
+    std::string filePath;
+};
+
 } // namespace openpower::dump::utility